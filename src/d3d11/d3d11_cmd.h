@@ -1,5 +1,8 @@
 #pragma once
 
+#include "../dxvk/dxvk_buffer.h"
+#include "../dxvk/dxvk_image.h"
+
 #include "d3d11_include.h"
 
 namespace dxvk {
@@ -32,4 +35,30 @@ namespace dxvk {
     uint32_t            stride;
   };
 
+
+  /**
+   * \brief Constant buffer binding data
+   *
+   * Used to bind multiple constant buffers of
+   * a single shader stage with one command.
+   */
+  struct D3D11CmdConstantBufferBinding {
+    uint32_t            slotId;
+    DxvkBufferSlice     bufferSlice;
+  };
+
+
+  /**
+   * \brief Shader resource binding data
+   *
+   * Used to bind multiple shader resources of a
+   * single shader stage with one command. At most
+   * one of the two views will be non-null.
+   */
+  struct D3D11CmdShaderResourceBinding {
+    uint32_t            slotId;
+    Rc<DxvkImageView>   imageView;
+    Rc<DxvkBufferView>  bufferView;
+  };
+
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "d3d11_cmdlist.h"
 #include "d3d11_device.h"
 #include "d3d11_buffer.h"
@@ -56,6 +58,7 @@ namespace dxvk {
 
   uint64_t D3D11CommandList::AddChunk(DxvkCsChunkRef&& Chunk, uint64_t Cost) {
     m_chunks.emplace_back(std::move(Chunk), Cost);
+    m_planValid = false;
     return m_chunks.size() - 1;
   }
   
@@ -79,6 +82,8 @@ namespace dxvk {
       m_resources.push_back(std::move(entry));
     }
 
+    m_planValid = false;
+
     // Return ID of the last chunk added. The command list
     // added can never be empty, so do not handle zero.
     return m_chunks.size() - 1;
@@ -90,20 +95,25 @@ namespace dxvk {
     for (const auto& query : m_queries)
       query->DoDeferredEnd();
 
-    for (size_t i = 0, j = 0; i < m_chunks.size(); i++) {
-      // If there are resources to track for the current chunk,
-      // use a strong flush hint to dispatch GPU work quickly.
-      GpuFlushType flushType = GpuFlushType::ImplicitWeakHint;
+    // The plan only depends on the contents of the command list,
+    // so it can be reused for as long as those do not change
+    if (!m_planValid)
+      BuildDispatchPlan();
 
-      if (j < m_resources.size() && m_resources[j].chunkId == i)
-        flushType = GpuFlushType::ImplicitStrongHint;
+    std::array<DxvkCsChunkRef, MaxChunksPerBatch> chunks;
 
-      // Dispatch the chunk and capture its sequence number
-      uint64_t seq = DispatchProc(DxvkCsChunkRef(m_chunks[i].chunk), m_chunks[i].cost, flushType);
+    for (const auto& batch : m_planBatches) {
+      for (size_t i = 0; i < batch.chunkCount; i++)
+        chunks[i] = m_chunks[batch.firstChunk + i].chunk;
 
-      // Track resource sequence numbers for the added chunk
-      while (j < m_resources.size() && m_resources[j].chunkId == i)
-        TrackResourceSequenceNumber(m_resources[j++].ref, seq);
+      // Dispatch the batch and capture the sequence number of its first chunk
+      uint64_t seq = DispatchProc(batch.chunkCount, chunks.data(), batch.cost, batch.flushType);
+
+      // Track resource sequence numbers for the added chunks
+      for (size_t i = 0; i < batch.resourceCount; i++) {
+        const auto& resource = m_resources[m_planResources[batch.firstResource + i]];
+        TrackResourceSequenceNumber(resource.ref, seq + resource.chunkId - batch.firstChunk);
+      }
     }
   }
   
@@ -118,6 +128,78 @@ namespace dxvk {
     entry.chunkId = ChunkId;
 
     m_resources.push_back(std::move(entry));
+    m_planValid = false;
+  }
+
+
+  void D3D11CommandList::BuildDispatchPlan() {
+    m_planBatches.clear();
+    m_planResources.clear();
+
+    // Tracking a sequence number overrides any previously tracked
+    // one, so only the last use of each subresource matters. Since
+    // resources are ordered by chunk ID, the highest index wins.
+    std::vector<uint32_t> order(m_resources.size());
+
+    for (uint32_t i = 0; i < order.size(); i++)
+      order[i] = i;
+
+    std::sort(order.begin(), order.end(), [this] (uint32_t a, uint32_t b) {
+      const auto& ra = m_resources[a].ref;
+      const auto& rb = m_resources[b].ref;
+
+      if (ra.Get() != rb.Get())
+        return ra.Get() < rb.Get();
+
+      if (ra.GetSubresource() != rb.GetSubresource())
+        return ra.GetSubresource() < rb.GetSubresource();
+
+      return a > b;
+    });
+
+    for (size_t i = 0; i < order.size(); i++) {
+      const auto& ref = m_resources[order[i]].ref;
+
+      if (i && m_resources[order[i - 1]].ref.Get() == ref.Get()
+            && m_resources[order[i - 1]].ref.GetSubresource() == ref.GetSubresource())
+        continue;
+
+      m_planResources.push_back(order[i]);
+    }
+
+    std::sort(m_planResources.begin(), m_planResources.end());
+
+    // Split chunks into batches. A batch ends after any chunk that has
+    // tracked resources, so that we can still use a strong flush hint.
+    for (size_t i = 0, j = 0, k = 0; i < m_chunks.size(); ) {
+      DispatchBatch batch = { };
+      batch.firstChunk = i;
+      batch.firstResource = k;
+      batch.flushType = GpuFlushType::ImplicitWeakHint;
+
+      while (i < m_chunks.size() && i - batch.firstChunk < MaxChunksPerBatch) {
+        bool hasResources = j < m_resources.size() && m_resources[j].chunkId == i;
+        batch.cost += m_chunks[i++].cost;
+
+        while (j < m_resources.size() && m_resources[j].chunkId < i)
+          j++;
+
+        if (hasResources) {
+          batch.flushType = GpuFlushType::ImplicitStrongHint;
+          break;
+        }
+      }
+
+      while (k < m_planResources.size() && m_resources[m_planResources[k]].chunkId < i)
+        k++;
+
+      batch.chunkCount = i - batch.firstChunk;
+      batch.resourceCount = k - batch.firstResource;
+
+      m_planBatches.push_back(batch);
+    }
+
+    m_planValid = true;
   }
 
 
@@ -1,12 +1,13 @@
 #pragma once
 
+#include <array>
 #include <functional>
 
 #include "d3d11_context.h"
 
 namespace dxvk {
   
-  using D3D11ChunkDispatchProc = std::function<uint64_t (DxvkCsChunkRef&&, uint64_t, GpuFlushType)>;
+  using D3D11ChunkDispatchProc = std::function<uint64_t (size_t, DxvkCsChunkRef*, uint64_t, GpuFlushType)>;
 
   class D3D11CommandList : public D3D11DeviceChild<ID3D11CommandList> {
     
@@ -37,6 +38,25 @@ namespace dxvk {
     void EmitToCsThread(
       const D3D11ChunkDispatchProc& DispatchProc);
 
+    /**
+     * \brief Queries number of chunks
+     * \returns Number of CS chunks in the command list
+     */
+    size_t GetChunkCount() const {
+      return m_chunks.size();
+    }
+
+    /**
+     * \brief Checks whether a dispatch plan is cached
+     *
+     * The plan is built on the first execution and reused on
+     * subsequent executions until the command list changes.
+     * \returns \c true if the next execution reuses the plan
+     */
+    bool HasDispatchPlan() const {
+      return m_planValid;
+    }
+
     void TrackResourceUsage(
             ID3D11Resource*     pResource,
             D3D11_RESOURCE_DIMENSION ResourceType,
@@ -45,6 +65,9 @@ namespace dxvk {
 
   private:
 
+    /// Maximum number of chunks to dispatch at once
+    constexpr static size_t MaxChunksPerBatch = 16u;
+
     struct ChunkEntry {
       ChunkEntry() = default;
       ChunkEntry(DxvkCsChunkRef&& c, uint64_t v)
@@ -58,14 +81,29 @@ namespace dxvk {
       uint64_t          chunkId;
     };
 
+    struct DispatchBatch {
+      size_t        firstChunk;
+      size_t        chunkCount;
+      size_t        firstResource;
+      size_t        resourceCount;
+      uint64_t      cost;
+      GpuFlushType  flushType;
+    };
+
     UINT m_contextFlags = 0u;
+    bool m_planValid = false;
 
     std::vector<ChunkEntry>             m_chunks;
     std::vector<Com<D3D11Query, false>> m_queries;
     std::vector<TrackedResource>        m_resources;
 
+    std::vector<DispatchBatch>          m_planBatches;
+    std::vector<uint32_t>               m_planResources;
+
     D3DDestructionNotifier              m_destructionNotifier;
 
+    void BuildDispatchPlan();
+
     void TrackResourceSequenceNumber(
       const D3D11ResourceRef&   Resource,
             uint64_t            Seq);
@@ -3161,11 +3161,40 @@ namespace dxvk {
     const auto& state = m_state.cbv[Stage];
     DirtyMask.cbvMask -= bindMask;
 
-    for (uint32_t slot : bit::BitMask(bindMask)) {
+    uint32_t bindCount = bit::popcnt(bindMask);
+
+    if (bindCount == 1u) {
+      uint32_t slot = bit::tzcnt(bindMask);
       const auto& cbv = state.buffers[slot];
 
       BindConstantBuffer(Stage, slot, cbv.buffer.ptr(),
         cbv.constantOffset, cbv.constantBound);
+      return;
+    }
+
+    // Engines tend to rebind entire constant buffer tables between
+    // draws, so emit a single command for all changed bindings
+    EmitCsCmd<D3D11CmdConstantBufferBinding>(D3D11CmdType::None, bindCount, [
+      cStage = GetShaderStage(Stage)
+    ] (DxvkContext* ctx, D3D11CmdConstantBufferBinding* bindings, size_t count) {
+      for (size_t i = 0; i < count; i++) {
+        ctx->bindUniformBuffer(cStage, bindings[i].slotId,
+          Forwarder::move(bindings[i].bufferSlice));
+      }
+    });
+
+    uint32_t index = 0u;
+
+    for (uint32_t slot : bit::BitMask(bindMask)) {
+      const auto& cbv = state.buffers[slot];
+
+      auto binding = new (m_csData->at(index++)) D3D11CmdConstantBufferBinding();
+      binding->slotId = D3D11ShaderResourceMapping::computeCbvBinding(Stage, slot);
+
+      if (cbv.buffer.ptr()) {
+        binding->bufferSlice = cbv.buffer->GetBufferSlice(
+          16u * cbv.constantOffset, 16u * cbv.constantBound);
+      }
     }
   }
 
@@ -3196,18 +3225,61 @@ namespace dxvk {
           D3D11BindingMask&                 DirtyMask) {
     const auto& state = m_state.srv[Stage];
 
+    std::array<uint64_t, 2> bindMasks = { };
+    uint32_t bindCount = 0u;
+
     for (uint32_t i = 0; i < state.maxCount; i += 64u) {
       uint32_t maskIndex = i / 64u;
       uint64_t bindMask = BoundMask.srvMask[maskIndex] & DirtyMask.srvMask[maskIndex];
 
-      if (!bindMask)
-        continue;
-
-    // Need to clear dirty bits before binding
+      // Need to clear dirty bits before binding
       DirtyMask.srvMask[maskIndex] -= bindMask;
 
-      for (uint32_t slot : bit::BitMask(bindMask))
-        BindShaderResource(Stage, slot + i, state.views[slot + i].ptr());
+      bindMasks[maskIndex] = bindMask;
+      bindCount += bit::popcnt(bindMask);
+    }
+
+    if (bindCount <= 1u) {
+      for (uint32_t i = 0; i < state.maxCount; i += 64u) {
+        for (uint32_t slot : bit::BitMask(bindMasks[i / 64u]))
+          BindShaderResource(Stage, slot + i, state.views[slot + i].ptr());
+      }
+
+      return;
+    }
+
+    // Emit a single command for all changed bindings rather than one
+    // per slot. The DXVK context will skip views that did not change.
+    EmitCsCmd<D3D11CmdShaderResourceBinding>(D3D11CmdType::None, bindCount, [
+      cStage = GetShaderStage(Stage)
+    ] (DxvkContext* ctx, D3D11CmdShaderResourceBinding* bindings, size_t count) {
+      for (size_t i = 0; i < count; i++) {
+        if (bindings[i].bufferView != nullptr) {
+          ctx->bindResourceBufferView(cStage, bindings[i].slotId,
+            Forwarder::move(bindings[i].bufferView));
+        } else {
+          ctx->bindResourceImageView(cStage, bindings[i].slotId,
+            Forwarder::move(bindings[i].imageView));
+        }
+      }
+    });
+
+    uint32_t index = 0u;
+
+    for (uint32_t i = 0; i < state.maxCount; i += 64u) {
+      for (uint32_t slot : bit::BitMask(bindMasks[i / 64u])) {
+        auto view = state.views[slot + i].ptr();
+
+        auto binding = new (m_csData->at(index++)) D3D11CmdShaderResourceBinding();
+        binding->slotId = D3D11ShaderResourceMapping::computeSrvBinding(Stage, slot + i);
+
+        if (view) {
+          if (view->GetViewInfo().Dimension == D3D11_RESOURCE_DIMENSION_BUFFER)
+            binding->bufferView = view->GetBufferView();
+          else
+            binding->imageView = view->GetImageView();
+        }
+      }
     }
   }
 
@@ -368,7 +368,6 @@ namespace dxvk {
       // safely ignore the MapBuffer return value here
       D3D11_MAPPED_SUBRESOURCE mapInfo;
       MapBuffer(pDstBuffer, &mapInfo);
-      AddMapEntry(pDstBuffer->GetCookie(), mapInfo);
       mapPtr = mapInfo.pData;
     }
 
@@ -426,25 +425,20 @@ namespace dxvk {
 
   D3D11_MAPPED_SUBRESOURCE D3D11DeferredContext::FindMapEntry(
           uint64_t                      Cookie) {
-    // Recently mapped resources as well as entries with
-    // up-to-date map infos will be located at the end
-    // of the resource array, so scan in reverse order.
-    size_t size = m_mappedResources.size();
+    auto entry = m_mappedResources.find(Cookie);
 
-    for (size_t i = 1; i <= size; i++) {
-      const auto& entry = m_mappedResources[size - i];
+    if (entry == m_mappedResources.end())
+      return D3D11_MAPPED_SUBRESOURCE();
 
-      if (entry.ResourceCookie == Cookie)
-        return entry.MapInfo;
-    }
-
-    return D3D11_MAPPED_SUBRESOURCE();
+    return entry->second;
   }
 
   void D3D11DeferredContext::AddMapEntry(
           uint64_t                      Cookie,
     const D3D11_MAPPED_SUBRESOURCE&     MapInfo) {
-    m_mappedResources.push_back({ Cookie, MapInfo });
+    // Later maps of the same resource replace the previous
+    // entry, since only the most recent one can be used.
+    m_mappedResources.insert_or_assign(Cookie, MapInfo);
   }
 
 }
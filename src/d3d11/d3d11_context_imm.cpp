@@ -10,6 +10,8 @@ constexpr static uint32_t MinFlushIntervalUs = 750;
 constexpr static uint32_t IncFlushIntervalUs = 250;
 constexpr static uint32_t MaxPendingSubmits  = 6;
 
+constexpr static uint32_t QuerySpinThreshold = 16;
+
 namespace dxvk {
   
   D3D11ImmediateContext::D3D11ImmediateContext(
@@ -88,26 +90,58 @@ namespace dxvk {
     // DataSize is 0, but we should ignore that pointer
     pData = DataSize ? pData : nullptr;
 
-    // Get query status directly from the query object
+    // Get query status directly from the query object. If the
+    // submission ending the query is known and has not completed
+    // yet, this is a lock-free read of the submission fence.
     auto query = static_cast<D3D11Query*>(pAsync);
-    HRESULT hr = query->GetData(pData, GetDataFlags);
+    uint64_t completedSubmission = m_submissionFence->value();
+    HRESULT hr = query->GetData(pData, GetDataFlags, completedSubmission);
     
     // If we're likely going to spin on the asynchronous object,
     // flush the context so that we're keeping the GPU busy.
     if (hr == S_FALSE) {
+      m_querySpins.fetch_add(1u, std::memory_order_relaxed);
+
+      uint64_t querySubmission = query->GetSubmissionId();
+
+      if (querySubmission > completedSubmission)
+        m_queryFenceHits.fetch_add(1u, std::memory_order_relaxed);
+
       // Don't mark the event query as stalling if the app does
       // not intend to spin on it. This reduces flushes on End.
       if (!(GetDataFlags & D3D11_ASYNC_GETDATA_DONOTFLUSH))
         query->NotifyStall();
 
-      // Ignore the DONOTFLUSH flag here as some games will spin
-      // on queries without ever flushing the context otherwise.
-      D3D10DeviceLock lock = LockContext();
+      // If the submission containing the query has already been
+      // flushed, all we can do is wait for the GPU, so there is
+      // no need to lock the context just to consider a flush.
+      bool isSubmitted = querySubmission
+        && querySubmission <= m_submissionId.load(std::memory_order_acquire);
+
+      if (!isSubmitted) {
+        // Ignore the DONOTFLUSH flag here as some games will spin
+        // on queries without ever flushing the context otherwise.
+        D3D10DeviceLock lock = LockContext();
 
-      if (unlikely(m_device->debugFlags().test(DxvkDebugFlag::Capture)))
-        m_flushReason = "Query read-back";
+        if (unlikely(m_device->debugFlags().test(DxvkDebugFlag::Capture)))
+          m_flushReason = "Query read-back";
 
-      ConsiderFlush(GpuFlushType::ImplicitSynchronization);
+        ConsiderFlush(GpuFlushType::ImplicitSynchronization);
+
+        isSubmitted = querySubmission
+          && querySubmission <= m_submissionId.load(std::memory_order_relaxed);
+      }
+
+      // If the app keeps polling a query that has already been
+      // submitted, block for a bounded amount of time instead of
+      // letting it spin, and re-check once the submission is done.
+      uint32_t maxWaitTime = uint32_t(std::max(m_parent->GetOptions()->queryWaitTime, 0));
+
+      if (maxWaitTime && isSubmitted && query->NotifySpin() >= QuerySpinThreshold
+       && !(GetDataFlags & D3D11_ASYNC_GETDATA_DONOTFLUSH)) {
+        if (WaitForSubmission(querySubmission, maxWaitTime))
+          hr = query->GetData(pData, GetDataFlags, m_submissionFence->value());
+      }
     }
     
     return hr;
@@ -152,6 +186,9 @@ namespace dxvk {
       cQuery->End(ctx);
     });
 
+    // The query will be part of the next submission at the latest
+    query->SetSubmissionId(m_submissionId.load(std::memory_order_relaxed) + 1u);
+
     if (unlikely(query->TrackStalls())) {
       query->NotifyEnd();
 
@@ -260,15 +297,21 @@ namespace dxvk {
     // number of pending draw calls is high enough.
     ConsiderFlush(GpuFlushType::ImplicitWeakHint);
 
-    // Dispatch command list to the CS thread
-    commandList->EmitToCsThread([this] (DxvkCsChunkRef&& chunk, uint64_t cost, GpuFlushType flushType) {
-      EmitCsChunk(std::move(chunk));
+    // Command lists that are executed repeatedly reuse the dispatch
+    // plan built on their first execution, count those for the HUD.
+    m_cmdListExecuted.fetch_add(1u, std::memory_order_relaxed);
+    m_cmdListChunks.fetch_add(commandList->GetChunkCount(), std::memory_order_relaxed);
+
+    if (commandList->HasDispatchPlan())
+      m_cmdListReused.fetch_add(1u, std::memory_order_relaxed);
 
+    // Dispatch command list to the CS thread
+    commandList->EmitToCsThread([this] (size_t count, DxvkCsChunkRef* chunks, uint64_t cost, GpuFlushType flushType) {
       // Return the sequence number from before the flush since
       // that is actually going to be needed for resource tracking
-      uint64_t csSeqNum = m_csSeqNum;
+      uint64_t csSeqNum = EmitCsChunks(count, chunks);
 
-      // Consider a flush after every chunk in case the app
+      // Consider a flush after every batch in case the app
       // submits a very large command list or the GPU is idle
       AddCost(cost);
       ConsiderFlush(flushType);
@@ -874,6 +917,43 @@ namespace dxvk {
   void D3D11ImmediateContext::SynchronizeDevice() {
     m_device->waitForIdle();
   }
+
+
+
+  bool D3D11ImmediateContext::WaitForSubmission(
+          uint64_t                    SubmissionId,
+          uint32_t                    MaxWaitTime) {
+    if (m_submissionFence->value() >= SubmissionId)
+      return true;
+
+    // Yield a few times first since the GPU is usually close to done
+    // by the time an app starts spinning, then block on the fence,
+    // which the queue's finish thread signals once the submission
+    // has retired. This avoids keeping a CPU core busy.
+    auto t0 = dxvk::high_resolution_clock::now();
+    bool done = false;
+
+    for (uint32_t i = 0; i < 8u && !done; i++) {
+      dxvk::this_thread::yield();
+      done = m_submissionFence->value() >= SubmissionId;
+    }
+
+    auto t1 = dxvk::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+    if (!done && elapsed.count() < MaxWaitTime) {
+      auto timeout = std::chrono::microseconds(MaxWaitTime) - elapsed;
+      done = m_submissionFence->wait(SubmissionId, timeout);
+
+      t1 = dxvk::high_resolution_clock::now();
+    }
+
+    auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+    m_queryWaits.fetch_add(1u, std::memory_order_relaxed);
+    m_queryWaitTicks.fetch_add(ticks.count(), std::memory_order_relaxed);
+    return done;
+  }
   
   
   void D3D11ImmediateContext::EndFrame(
@@ -893,6 +973,18 @@ namespace dxvk {
       if (cTracker && cTracker->needsAutoMarkers())
         ctx->endLatencyTracking(cTracker);
     });
+
+    // Feed measured idle times back into the flush heuristic
+    if (m_device->config().adaptiveFlush) {
+      GpuFlushFeedback feedback;
+      feedback.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+        dxvk::high_resolution_clock::now().time_since_epoch()).count();
+      feedback.gpuIdleTicks = m_device->getStatCtr(DxvkStatCounter::GpuIdleTicks);
+      feedback.csIdleTicks = m_device->getStatCtr(DxvkStatCounter::CsIdleTicks);
+      feedback.presentSyncTicks = m_device->getStatCtr(DxvkStatCounter::PresentSyncTicks);
+
+      m_flushTracker.notifyFrame(feedback);
+    }
   }
 
 
@@ -959,6 +1051,17 @@ namespace dxvk {
   }
 
 
+  uint64_t D3D11ImmediateContext::EmitCsChunks(
+          size_t                      ChunkCount,
+          DxvkCsChunkRef*             pChunks) {
+    m_parent->FlushInitCommands();
+
+    uint64_t seq = m_csThread.dispatchChunks(ChunkCount, pChunks);
+    m_csSeqNum = seq + ChunkCount - 1u;
+    return seq;
+  }
+
+
   void D3D11ImmediateContext::TrackTextureSequenceNumber(
           D3D11CommonTexture*         pResource,
           UINT                        Subresource) {
@@ -1116,7 +1219,7 @@ namespace dxvk {
     ApplyDirtyNullBindings();
 
     // Signal the submission fence and flush the command list
-    uint64_t submissionId = ++m_submissionId;
+    uint64_t submissionId = m_submissionId.fetch_add(1u, std::memory_order_release) + 1u;
 
     if (hEvent) {
       m_submissionFence->setCallback(submissionId, [hEvent] {
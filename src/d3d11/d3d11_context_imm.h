@@ -13,6 +13,34 @@ namespace dxvk {
   class D3D11Buffer;
   class D3D11CommonTexture;
 
+  /**
+   * \brief Command list execution statistics
+   *
+   * Counts command lists executed on the immediate
+   * context, and how many of those reused a cached
+   * dispatch plan. Used for the \c cmdlists HUD item.
+   */
+  struct D3D11CommandListStats {
+    uint64_t executed = 0u;
+    uint64_t reused   = 0u;
+    uint64_t chunks   = 0u;
+  };
+
+  /**
+   * \brief Query polling statistics
+   *
+   * Counts \c GetData calls that did not return any data,
+   * how many of those were answered from the submission
+   * fence alone, and how often and how long the context
+   * blocked on a query that the app was spinning on.
+   */
+  struct D3D11QueryStats {
+    uint64_t spins      = 0u;
+    uint64_t fenceHits  = 0u;
+    uint64_t waits      = 0u;
+    uint64_t waitTicks  = 0u;
+  };
+
   class D3D11ImmediateContext : public D3D11CommonContext<D3D11ImmediateContext> {
     friend class D3D11CommonContext<D3D11ImmediateContext>;
     friend class D3D11SwapChain;
@@ -102,6 +130,35 @@ namespace dxvk {
             DxvkCsChunkRef&&            Chunk,
             bool                        Synchronize);
 
+    /**
+     * \brief Queries command list execution statistics
+     *
+     * Can be called from any thread.
+     * \returns Cumulative command list statistics
+     */
+    D3D11CommandListStats GetCommandListStats() const {
+      D3D11CommandListStats result;
+      result.executed = m_cmdListExecuted.load(std::memory_order_relaxed);
+      result.reused   = m_cmdListReused.load(std::memory_order_relaxed);
+      result.chunks   = m_cmdListChunks.load(std::memory_order_relaxed);
+      return result;
+    }
+
+    /**
+     * \brief Queries query polling statistics
+     *
+     * Can be called from any thread.
+     * \returns Cumulative query statistics
+     */
+    D3D11QueryStats GetQueryStats() const {
+      D3D11QueryStats result;
+      result.spins      = m_querySpins.load(std::memory_order_relaxed);
+      result.fenceHits  = m_queryFenceHits.load(std::memory_order_relaxed);
+      result.waits      = m_queryWaits.load(std::memory_order_relaxed);
+      result.waitTicks  = m_queryWaitTicks.load(std::memory_order_relaxed);
+      return result;
+    }
+
     template<typename Fn>
     void InjectCs(
             DxvkCsQueue                 Queue,
@@ -120,7 +177,7 @@ namespace dxvk {
     uint32_t                m_mappedImageCount = 0u;
 
     Rc<sync::CallbackFence> m_submissionFence;
-    uint64_t                m_submissionId = 0ull;
+    std::atomic<uint64_t>   m_submissionId = { 0ull };
     DxvkSubmitStatus        m_submitStatus;
 
     uint64_t                m_flushSeqNum = 0ull;
@@ -140,6 +197,15 @@ namespace dxvk {
 
     std::string             m_flushReason;
 
+    std::atomic<uint64_t>   m_cmdListExecuted = { 0ull };
+    std::atomic<uint64_t>   m_cmdListReused   = { 0ull };
+    std::atomic<uint64_t>   m_cmdListChunks   = { 0ull };
+
+    std::atomic<uint64_t>   m_querySpins      = { 0ull };
+    std::atomic<uint64_t>   m_queryFenceHits  = { 0ull };
+    std::atomic<uint64_t>   m_queryWaits      = { 0ull };
+    std::atomic<uint64_t>   m_queryWaitTicks  = { 0ull };
+
     HRESULT MapBuffer(
             D3D11Buffer*                pResource,
             D3D11_MAP                   MapType,
@@ -175,6 +241,10 @@ namespace dxvk {
 
     void SynchronizeDevice();
 
+    bool WaitForSubmission(
+            uint64_t                    SubmissionId,
+            uint32_t                    MaxWaitTime);
+
     void EndFrame(
             Rc<DxvkLatencyTracker>      LatencyTracker);
     
@@ -186,6 +256,10 @@ namespace dxvk {
     
     void EmitCsChunk(DxvkCsChunkRef&& chunk);
 
+    uint64_t EmitCsChunks(
+            size_t                      ChunkCount,
+            DxvkCsChunkRef*             pChunks);
+
     void TrackTextureSequenceNumber(
             D3D11CommonTexture*         pResource,
             UINT                        Subresource);
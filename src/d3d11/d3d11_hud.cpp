@@ -0,0 +1,104 @@
+#include "d3d11_hud.h"
+
+namespace dxvk::hud {
+
+  HudCommandLists::HudCommandLists(D3D11ImmediateContext* context)
+  : m_context         (context)
+  , m_prevStats       (context->GetCommandListStats())
+  , m_executedString  ("")
+  , m_reusedString    ("") { }
+
+
+  void HudCommandLists::update(dxvk::high_resolution_clock::time_point time) {
+    m_frameCount += 1u;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
+
+    if (elapsed.count() < UpdateInterval)
+      return;
+
+    D3D11CommandListStats stats = m_context->GetCommandListStats();
+
+    uint64_t executedPerFrame = (stats.executed - m_prevStats.executed) / m_frameCount;
+    uint64_t reusedPerFrame   = (stats.reused   - m_prevStats.reused)   / m_frameCount;
+    uint64_t chunksPerFrame   = (stats.chunks   - m_prevStats.chunks)   / m_frameCount;
+
+    m_executedString = str::format(executedPerFrame, " (", chunksPerFrame, " chunks)");
+    m_reusedString = str::format(reusedPerFrame);
+
+    m_prevStats = stats;
+    m_frameCount = 0u;
+    m_lastUpdate = time;
+  }
+
+
+  HudPos HudCommandLists::render(
+    const Rc<DxvkCommandList>&ctx,
+    const HudPipelineKey&     key,
+    const HudOptions&         options,
+          HudRenderer&        renderer,
+          HudPos              position) {
+    position.y += 16;
+    renderer.drawText(16, position, 0xffc0ff00u, "Cmd lists:");
+    renderer.drawText(16, { position.x + 120, position.y }, 0xffffffffu, m_executedString);
+
+    position.y += 20;
+    renderer.drawText(16, position, 0xffc0ff00u, "Reused:");
+    renderer.drawText(16, { position.x + 120, position.y }, 0xffffffffu, m_reusedString);
+
+    position.y += 8;
+    return position;
+  }
+
+
+
+  HudQueryStats::HudQueryStats(D3D11ImmediateContext* context)
+  : m_context     (context)
+  , m_prevStats   (context->GetQueryStats())
+  , m_spinString  ("")
+  , m_waitString  ("") { }
+
+
+  void HudQueryStats::update(dxvk::high_resolution_clock::time_point time) {
+    m_frameCount += 1u;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
+
+    if (elapsed.count() < UpdateInterval)
+      return;
+
+    D3D11QueryStats stats = m_context->GetQueryStats();
+
+    uint64_t spinsPerFrame     = (stats.spins     - m_prevStats.spins)     / m_frameCount;
+    uint64_t fenceHitsPerFrame = (stats.fenceHits - m_prevStats.fenceHits) / m_frameCount;
+    uint64_t waitsPerFrame     = (stats.waits     - m_prevStats.waits)     / m_frameCount;
+    uint64_t waitTimePerFrame  = (stats.waitTicks - m_prevStats.waitTicks) / m_frameCount;
+
+    m_spinString = str::format(spinsPerFrame, " (", fenceHitsPerFrame, " from fence)");
+    m_waitString = str::format(waitsPerFrame, " (", waitTimePerFrame, " us)");
+
+    m_prevStats = stats;
+    m_frameCount = 0u;
+    m_lastUpdate = time;
+  }
+
+
+  HudPos HudQueryStats::render(
+    const Rc<DxvkCommandList>&ctx,
+    const HudPipelineKey&     key,
+    const HudOptions&         options,
+          HudRenderer&        renderer,
+          HudPos              position) {
+    position.y += 16;
+    renderer.drawText(16, position, 0xffc0ff00u, "Query spins:");
+    renderer.drawText(16, { position.x + 140, position.y }, 0xffffffffu, m_spinString);
+
+    position.y += 20;
+    renderer.drawText(16, position, 0xffc0ff00u, "Query waits:");
+    renderer.drawText(16, { position.x + 140, position.y }, 0xffffffffu, m_waitString);
+
+    position.y += 8;
+    return position;
+  }
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "d3d11_context_imm.h"
+#include "../dxvk/hud/dxvk_hud_item.h"
+
+namespace dxvk::hud {
+
+  /**
+   * \brief HUD item to display command list executions
+   */
+  class HudCommandLists : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudCommandLists(D3D11ImmediateContext* context);
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+      const Rc<DxvkCommandList>&ctx,
+      const HudPipelineKey&     key,
+      const HudOptions&         options,
+            HudRenderer&        renderer,
+            HudPos              position);
+
+  private:
+
+    D3D11ImmediateContext* m_context;
+
+    D3D11CommandListStats m_prevStats;
+    uint32_t              m_frameCount = 0u;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    std::string m_executedString;
+    std::string m_reusedString;
+
+  };
+
+
+  /**
+   * \brief HUD item to display query polling statistics
+   */
+  class HudQueryStats : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudQueryStats(D3D11ImmediateContext* context);
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+      const Rc<DxvkCommandList>&ctx,
+      const HudPipelineKey&     key,
+      const HudOptions&         options,
+            HudRenderer&        renderer,
+            HudPos              position);
+
+  private:
+
+    D3D11ImmediateContext* m_context;
+
+    D3D11QueryStats m_prevStats;
+    uint32_t        m_frameCount = 0u;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    std::string m_spinString;
+    std::string m_waitString;
+
+  };
+
+}
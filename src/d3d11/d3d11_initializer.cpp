@@ -81,7 +81,7 @@ namespace dxvk {
           D3D11CommonShader*          pShader,
           size_t                      IcbSize,
     const void*                       pIcbData) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
     m_transferCommands += 1;
 
     auto icbSlice = pShader->GetIcb();
@@ -100,21 +100,28 @@ namespace dxvk {
         cSrcSlice.buffer(), cSrcSlice.offset(), cIcbSlice.length());
     });
 
-    ThrottleAllocationLocked();
+    ThrottleAllocation(lock);
   }
 
 
   void D3D11Initializer::InitDeviceLocalBuffer(
           D3D11Buffer*                pBuffer,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
 
     Rc<DxvkBuffer> buffer = pBuffer->GetBuffer();
 
     if (pInitialData != nullptr && pInitialData->pSysMem != nullptr) {
       auto stagingSlice = m_stagingBuffer.alloc(buffer->info().size);
+
+      // The slice keeps its staging buffer alive, so we can
+      // copy the data without blocking any other threads.
+      lock.unlock();
+
       std::memcpy(stagingSlice.mapPtr(0), pInitialData->pSysMem, stagingSlice.length());
 
+      lock.lock();
+
       m_transferCommands += 1;
 
       EmitCs([
@@ -135,7 +142,7 @@ namespace dxvk {
       });
     }
 
-    ThrottleAllocationLocked();
+    ThrottleAllocation(lock);
   }
 
 
@@ -155,7 +162,7 @@ namespace dxvk {
   void D3D11Initializer::InitDeviceLocalTexture(
           D3D11CommonTexture*         pTexture,
     const D3D11_SUBRESOURCE_DATA*     pInitialData) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
     
     // Image migt be null if this is a staging resource
     Rc<DxvkImage> image = pTexture->GetImage();
@@ -179,6 +186,12 @@ namespace dxvk {
         stagingSlice = m_stagingBuffer.alloc(dataSize);
       }
 
+      // Packing the data is by far the most expensive part of texture
+      // creation. The staging slice stays valid even if the staging
+      // buffer gets reset, so let other threads allocate and upload
+      // their own resources in the meantime.
+      lock.unlock();
+
       // Copy initial data for each subresource into the staging buffer,
       // as well as the mapped per-subresource buffers if available.
       VkDeviceSize dataOffset = 0u;
@@ -192,8 +205,6 @@ namespace dxvk {
             VkDeviceSize mipSizePerLayer = util::computeImageDataSize(
               packedFormat, image->mipLevelExtent(mip), formatInfo->aspectMask);
 
-            m_transferCommands += 1;
-
             util::packImageData(stagingSlice.mapPtr(dataOffset),
               pInitialData[index].pSysMem, pInitialData[index].SysMemPitch, pInitialData[index].SysMemSlicePitch,
               0, 0, pTexture->GetVkImageType(), mipLevelExtent, 1, formatInfo, formatInfo->aspectMask);
@@ -209,8 +220,12 @@ namespace dxvk {
         }
       }
 
+      lock.lock();
+
       // Upload all subresources of the image in one go
       if (pTexture->HasImage()) {
+        m_transferCommands += desc->MipLevels * desc->ArraySize;
+
         EmitCs([
           cImage        = std::move(image),
           cStagingSlice = std::move(stagingSlice),
@@ -244,7 +259,7 @@ namespace dxvk {
       }
     }
 
-    ThrottleAllocationLocked();
+    ThrottleAllocation(lock);
   }
 
 
@@ -298,7 +313,7 @@ namespace dxvk {
     }
 
     // Initialize the image on the GPU
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
 
     EmitCs([
       cImage = std::move(image)
@@ -307,13 +322,13 @@ namespace dxvk {
     });
 
     m_transferCommands += 1;
-    ThrottleAllocationLocked();
+    ThrottleAllocation(lock);
   }
 
 
   void D3D11Initializer::InitTiledTexture(
           D3D11CommonTexture*         pTexture) {
-    std::lock_guard<dxvk::mutex> lock(m_mutex);
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
 
     EmitCs([
       cImage = pTexture->GetImage()
@@ -322,20 +337,25 @@ namespace dxvk {
     });
 
     m_transferCommands += 1;
-    ThrottleAllocationLocked();
+    ThrottleAllocation(lock);
   }
 
 
-  void D3D11Initializer::ThrottleAllocationLocked() {
+  void D3D11Initializer::ThrottleAllocation(
+          std::unique_lock<dxvk::mutex>& Lock) {
     DxvkStagingBufferStats stats = m_stagingBuffer.getStatistics();
 
     // If the amount of memory in flight exceeds the limit, stall the
     // calling thread and wait for some memory to actually get released.
+    // Drop the lock while waiting so that threads which create resources
+    // without initial data or with small uploads can still make progress.
     VkDeviceSize stagingMemoryInFlight = stats.allocatedTotal - m_stagingSignal->value();
 
     if (stagingMemoryInFlight > MaxMemoryInFlight) {
       ExecuteFlushLocked();
 
+      Lock.unlock();
+
       m_stagingSignal->wait(stats.allocatedTotal - MaxMemoryInFlight);
     } else if (m_transferCommands >= MaxCommandsPerSubmission || stats.allocatedSinceLastReset >= MaxMemoryPerSubmission) {
       // Flush pending commands if there are a lot of updates in flight
@@ -98,7 +98,8 @@ namespace dxvk {
     void InitTiledTexture(
             D3D11CommonTexture*         pTexture);
 
-    void ThrottleAllocationLocked();
+    void ThrottleAllocation(
+            std::unique_lock<dxvk::mutex>& Lock);
 
     void ExecuteFlush();
 
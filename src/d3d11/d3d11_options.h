@@ -102,6 +102,12 @@ namespace dxvk {
     /// Some games are broken and ignore row pitch.
     bool disableDirectImageMapping = false;
 
+    /// Maximum time, in microseconds, that GetData may block on a query
+    /// that the application is clearly spinning on. The calling thread
+    /// yields a few times, then waits on the submission fence without
+    /// exceeding the given time. 0 disables waiting.
+    int32_t queryWaitTime = 0;
+
     /// Shader dump path
     std::string shaderDumpPath;
   };
@@ -243,13 +243,22 @@ namespace dxvk {
 
   HRESULT STDMETHODCALLTYPE D3D11Query::GetData(
           void*                             pData,
-          UINT                              GetDataFlags) {
+          UINT                              GetDataFlags,
+          uint64_t                          CompletedSubmission) {
     if (m_state != D3D11_VK_QUERY_ENDED)
       return DXGI_ERROR_INVALID_CALL;
 
     if (m_resetCtr != 0u)
       return S_FALSE;
 
+    // If the submission that ends the query has not completed yet,
+    // results cannot be available, so don't bother polling Vulkan
+    // objects. Non-precise occlusion queries may become available
+    // early if an earlier submission already passed any samples.
+    if (m_submissionId.load(std::memory_order_acquire) > CompletedSubmission
+     && m_desc.Query != D3D11_QUERY_OCCLUSION_PREDICATE)
+      return S_FALSE;
+
     if (m_desc.Query == D3D11_QUERY_EVENT) {
       DxvkGpuEventStatus status = m_event[0]->test();
 
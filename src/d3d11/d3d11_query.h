@@ -46,13 +46,43 @@ namespace dxvk {
 
     HRESULT STDMETHODCALLTYPE GetData(
             void*                             pData,
-            UINT                              GetDataFlags);
+            UINT                              GetDataFlags,
+            uint64_t                          CompletedSubmission);
     
     void DoDeferredEnd() {
       m_state = D3D11_VK_QUERY_ENDED;
+      m_submissionId.store(0u, std::memory_order_release);
+      m_spinCount.store(0u, std::memory_order_relaxed);
       m_resetCtr.fetch_add(1, std::memory_order_acquire);
     }
 
+    /**
+     * \brief Sets submission that ends the query
+     *
+     * Set by the immediate context on \c End, so that \c GetData
+     * can tell that results are not available yet by reading the
+     * context's submission fence, without querying any Vulkan
+     * objects. The query may end up in an earlier submission if
+     * the context flushes on its own, which is harmless.
+     * \param [in] SubmissionId Submission ID, or 0 if unknown
+     */
+    void SetSubmissionId(uint64_t SubmissionId) {
+      m_submissionId.store(SubmissionId, std::memory_order_release);
+      m_spinCount.store(0u, std::memory_order_relaxed);
+    }
+
+    uint64_t GetSubmissionId() const {
+      return m_submissionId.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Counts unsuccessful \c GetData calls
+     * \returns Number of calls since the query was ended
+     */
+    uint32_t NotifySpin() {
+      return m_spinCount.fetch_add(1u, std::memory_order_relaxed) + 1u;
+    }
+
     bool IsScoped() const {
       return m_desc.Query != D3D11_QUERY_EVENT
           && m_desc.Query != D3D11_QUERY_TIMESTAMP;
@@ -113,6 +143,9 @@ namespace dxvk {
 
     std::atomic<uint32_t> m_resetCtr = { 0u };
 
+    std::atomic<uint64_t> m_submissionId = { 0u };
+    std::atomic<uint32_t> m_spinCount = { 0u };
+
     D3DDestructionNotifier m_destructionNotifier;
 
     UINT64 GetTimestampQueryFrequency() const;
@@ -232,7 +232,7 @@ namespace dxvk {
     const D3D11BindingMask&       BindingMask,
           D3D11CommonShader*      pShader) {
     // Use the shader's unique key for the lookup
-    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+    { std::shared_lock<dxvk::shared_mutex> lock(m_mutex);
       
       auto entry = m_modules.find(ShaderKey);
       if (entry != m_modules.end()) {
@@ -256,7 +256,7 @@ namespace dxvk {
     // Insert the new module into the lookup table. If another thread
     // has compiled the same shader in the meantime, we should return
     // that object instead and discard the newly created module.
-    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+    { std::unique_lock<dxvk::shared_mutex> lock(m_mutex);
       
       auto status = m_modules.insert({ ShaderKey, module });
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include "../dxvk/dxvk_device.h"
@@ -292,7 +293,9 @@ namespace dxvk {
     
   private:
     
-    dxvk::mutex m_mutex;
+    // Lookups vastly outnumber insertions, so only
+    // creating a new module takes the lock exclusively
+    dxvk::shared_mutex m_mutex;
     
     std::unordered_map<
       DxvkShaderHash,
@@ -1,5 +1,6 @@
 #include "d3d11_context_imm.h"
 #include "d3d11_device.h"
+#include "d3d11_hud.h"
 #include "d3d11_swapchain.h"
 
 #include "../dxvk/dxvk_latency_builtin.h"
@@ -601,6 +602,9 @@ namespace dxvk {
 
       if (m_latency)
         m_latencyHud = hud->addItem<hud::HudLatencyItem>("latency", 4);
+
+      hud->addItem<hud::HudCommandLists>("cmdlists", -1, m_parent->GetContext());
+      hud->addItem<hud::HudQueryStats>("queries", -1, m_parent->GetContext());
     }
 
     m_blitter = new DxvkSwapchainBlitter(m_device, std::move(hud));
@@ -627,9 +631,18 @@ namespace dxvk {
 
 
   void D3D11SwapChain::SyncFrameLatency() {
-    // Wait for the sync event so that we respect the maximum frame latency
+    // Wait for the sync event so that we respect the maximum frame latency.
+    // Track the time spent here since this is where vsync and the frame
+    // rate limiter block the application.
+    auto t0 = dxvk::high_resolution_clock::now();
+
     m_frameLatencySignal->wait(m_frameId - GetActualFrameLatency());
 
+    auto t1 = dxvk::high_resolution_clock::now();
+    auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+    m_device->addStatCtr(DxvkStatCounter::PresentSyncTicks, ticks.count());
+
     m_frameLatencySignal->setCallback(m_frameId, [this,
       cFrameId           = m_frameId,
       cFrameLatencyEvent = m_frameLatencyEvent
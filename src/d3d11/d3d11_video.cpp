@@ -1,8 +1,10 @@
 #include <algorithm>
+#include <cmath>
 
 #include "d3d11_context_imm.h"
 #include "d3d11_video.h"
 
+#include <d3d11_video_blit_comp.h>
 #include <d3d11_video_blit_frag.h>
 #include <d3d11_video_blit_vert.h>
 
@@ -1219,6 +1221,10 @@ namespace dxvk {
 
     m_dstIsYCbCr = outputView.IsYCbCr();
 
+    // Planar outputs need one pass per plane with a different
+    // export mode each, keep using the graphics path for those.
+    bool useCompute = !views[1] && CanUseComputeBlit(outputView);
+
     for (uint32_t vi = 0; vi < views.size(); vi++) {
       if (!views[vi])
         continue;
@@ -1243,7 +1249,7 @@ namespace dxvk {
         }
 
         if (!outputBound) {
-          BindOutputView(views[vi], views[0]);
+          BindOutputView(views[vi], views[0], useCompute);
           outputBound = true;
         }
 
@@ -1401,7 +1407,8 @@ namespace dxvk {
 
   void D3D11VideoContext::BindOutputView(
           Rc<DxvkImageView>               View,
-          Rc<DxvkImageView>               FirstView) {
+          Rc<DxvkImageView>               FirstView,
+          bool                            UseCompute) {
     VkExtent3D viewExtent = View->mipLevelExtent(0);
     m_dstExtent = { viewExtent.width, viewExtent.height };
 
@@ -1409,9 +1416,28 @@ namespace dxvk {
     m_dstSizeFact[0] = (float) viewExtent.width  / (float) firstExtent.width;
     m_dstSizeFact[1] = (float) viewExtent.height / (float) firstExtent.height;
 
-    m_ctx->EmitCs([
-      cView   = std::move(View)
+    m_ctx->EmitCs([this,
+      cView       = std::move(View),
+      cUseCompute = UseCompute
     ] (DxvkContext* ctx) {
+      m_csOutputView = nullptr;
+
+      if (cUseCompute) {
+        DxvkImageUsageInfo usage = { };
+        usage.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+        usage.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        usage.access = VK_ACCESS_SHADER_WRITE_BIT;
+
+        if (ctx->ensureImageCompatibility(cView->image(), usage)) {
+          DxvkImageViewKey viewKey = cView->info();
+          viewKey.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+          viewKey.layout = VK_IMAGE_LAYOUT_GENERAL;
+
+          m_csOutputView = cView->image()->createView(viewKey);
+          return;
+        }
+      }
+
       DxvkImageUsageInfo usage = { };
       usage.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
       usage.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -1461,7 +1487,9 @@ namespace dxvk {
     ] (DxvkContext* ctx) {
       DxvkImageUsageInfo usage = { };
       usage.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
-      usage.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+      usage.stages = m_csOutputView != nullptr
+        ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+        : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
       usage.access = VK_ACCESS_SHADER_READ_BIT;
 
       ctx->ensureImageCompatibility(cImage, usage);
@@ -1520,12 +1548,52 @@ namespace dxvk {
         uboData.yMax = 0.9215686f;
       }
 
+      // The compute path writes all pixels whose centers lie inside
+      // the viewport, which is exactly what rasterization would cover
+      uboData.dstOffset[0] = viewport.x;
+      uboData.dstOffset[1] = viewport.y;
+      uboData.dstScale[0] = 1.0f / viewport.width;
+      uboData.dstScale[1] = 1.0f / viewport.height;
+
+      int32_t dstX0 = std::clamp(int32_t(std::ceil(viewport.x - 0.5f)), 0, int32_t(cDstExtent.width));
+      int32_t dstY0 = std::clamp(int32_t(std::ceil(viewport.y - 0.5f)), 0, int32_t(cDstExtent.height));
+      int32_t dstX1 = std::clamp(int32_t(std::ceil(viewport.x + viewport.width - 0.5f)), dstX0, int32_t(cDstExtent.width));
+      int32_t dstY1 = std::clamp(int32_t(std::ceil(viewport.y + viewport.height - 0.5f)), dstY0, int32_t(cDstExtent.height));
+
+      uboData.dstRect.offset = { dstX0, dstY0 };
+      uboData.dstRect.extent = { uint32_t(dstX1 - dstX0), uint32_t(dstY1 - dstY0) };
+
       Rc<DxvkResourceAllocation> uboSlice = m_ubo->allocateStorage();
       memcpy(uboSlice->mapPtr(), &uboData, sizeof(uboData));
 
-      DxvkViewport vp = { viewport, scissor };
-
       ctx->invalidateBuffer(m_ubo, std::move(uboSlice));
+
+      if (m_csOutputView != nullptr) {
+        if (!uboData.dstRect.extent.width || !uboData.dstRect.extent.height)
+          return;
+
+        ctx->bindShader<VK_SHADER_STAGE_COMPUTE_BIT>(Rc<DxvkShader>(m_cs));
+        ctx->bindUniformBuffer(VK_SHADER_STAGE_COMPUTE_BIT, 0, DxvkBufferSlice(m_ubo));
+
+        for (uint32_t i = 0; i < cViews.size(); i++)
+          ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, 1 + i, Rc<DxvkImageView>(cViews[i]));
+
+        ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, 3, Rc<DxvkImageView>(m_csOutputView));
+
+        VkExtent3D workgroupCount = util::computeBlockCount(
+          VkExtent3D { uboData.dstRect.extent.width, uboData.dstRect.extent.height, 1u },
+          VkExtent3D { 8u, 8u, 1u });
+
+        ctx->dispatch(workgroupCount.width, workgroupCount.height, workgroupCount.depth);
+
+        for (uint32_t i = 0; i < cViews.size(); i++)
+          ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, 1 + i, nullptr);
+
+        ctx->bindResourceImageView(VK_SHADER_STAGE_COMPUTE_BIT, 3, nullptr);
+        return;
+      }
+
+      DxvkViewport vp = { viewport, scissor };
       ctx->setViewports(1, &vp);
 
       ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(Rc<DxvkShader>(m_vs));
@@ -1548,6 +1616,43 @@ namespace dxvk {
   }
 
 
+  bool D3D11VideoContext::CanUseComputeBlit(
+    const D3D11VideoProcessorView&        View) {
+    Rc<DxvkImageView> view = View.GetViews()[0];
+    DxvkImageViewKey viewKey = view->info();
+
+    if (viewKey.viewType != VK_IMAGE_VIEW_TYPE_2D)
+      return false;
+
+    // Storage image views cannot be swizzled
+    VkComponentMapping swizzle = viewKey.unpackSwizzle();
+
+    if ((swizzle.r != VK_COMPONENT_SWIZZLE_IDENTITY && swizzle.r != VK_COMPONENT_SWIZZLE_R)
+     || (swizzle.g != VK_COMPONENT_SWIZZLE_IDENTITY && swizzle.g != VK_COMPONENT_SWIZZLE_G)
+     || (swizzle.b != VK_COMPONENT_SWIZZLE_IDENTITY && swizzle.b != VK_COMPONENT_SWIZZLE_B)
+     || (swizzle.a != VK_COMPONENT_SWIZZLE_IDENTITY && swizzle.a != VK_COMPONENT_SWIZZLE_A))
+      return false;
+
+    // Shared images cannot be recreated with storage usage
+    if (view->image()->info().shared)
+      return false;
+
+    auto entry = m_computeFormats.find(viewKey.format);
+
+    if (entry != m_computeFormats.end())
+      return entry->second;
+
+    // The shader does not declare an image format
+    DxvkFormatFeatures features = m_device->adapter()->getFormatFeatures(viewKey.format);
+
+    bool supported = (features.optimal & VK_FORMAT_FEATURE_2_STORAGE_IMAGE_BIT)
+                  && (features.optimal & VK_FORMAT_FEATURE_2_STORAGE_WRITE_WITHOUT_FORMAT_BIT);
+
+    m_computeFormats.insert({ viewKey.format, supported });
+    return supported;
+  }
+
+
   void D3D11VideoContext::CopyBaseImageToShadow(
     const D3D11VideoProcessorView&        View) {
     auto shadow = View.GetShadow();
@@ -1586,7 +1691,8 @@ namespace dxvk {
     DxvkBufferCreateInfo bufferInfo;
     bufferInfo.size = sizeof(UboData);
     bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    bufferInfo.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    bufferInfo.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                      | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
     bufferInfo.access = VK_ACCESS_UNIFORM_READ_BIT;
     bufferInfo.debugName = "Video blit parameters";
 
@@ -1608,6 +1714,18 @@ namespace dxvk {
     fsInfo.bindingCount = fsBindings.size();
     fsInfo.bindings = fsBindings.data();
     m_fs = new DxvkSpirvShader(fsInfo, d3d11_video_blit_frag);
+
+    const std::array<DxvkBindingInfo, 4> csBindings = {{
+      { 0u, 0u, 0u, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1u, VK_IMAGE_VIEW_TYPE_MAX_ENUM, VK_ACCESS_UNIFORM_READ_BIT, DxvkDescriptorFlag::UniformBuffer },
+      { 0u, 1u, 1u, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  1u, VK_IMAGE_VIEW_TYPE_2D,       VK_ACCESS_SHADER_READ_BIT },
+      { 0u, 2u, 2u, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  1u, VK_IMAGE_VIEW_TYPE_2D,       VK_ACCESS_SHADER_READ_BIT },
+      { 0u, 3u, 3u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,  1u, VK_IMAGE_VIEW_TYPE_2D,       VK_ACCESS_SHADER_WRITE_BIT },
+    }};
+
+    DxvkSpirvShaderCreateInfo csInfo = { };
+    csInfo.bindingCount = csBindings.size();
+    csInfo.bindings = csBindings.data();
+    m_cs = new DxvkSpirvShader(csInfo, d3d11_video_blit_comp);
   }
 
 
@@ -1621,13 +1739,16 @@ namespace dxvk {
 
 
   void D3D11VideoContext::UnbindResources() {
-    m_ctx->EmitCs([] (DxvkContext* ctx) {
+    m_ctx->EmitCs([this] (DxvkContext* ctx) {
       ctx->bindRenderTargets(DxvkRenderTargets(), 0u);
 
       ctx->bindShader<VK_SHADER_STAGE_VERTEX_BIT>(nullptr);
       ctx->bindShader<VK_SHADER_STAGE_FRAGMENT_BIT>(nullptr);
+      ctx->bindShader<VK_SHADER_STAGE_COMPUTE_BIT>(nullptr);
+
+      ctx->bindUniformBuffer(VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT, 0, DxvkBufferSlice());
 
-      ctx->bindUniformBuffer(VK_SHADER_STAGE_FRAGMENT_BIT, 0, DxvkBufferSlice());
+      m_csOutputView = nullptr;
     });
   }
 
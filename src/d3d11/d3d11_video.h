@@ -661,6 +661,9 @@ namespace dxvk {
       float yMin, yMax;
       VkBool32 isPlanar;
       ExportMode exportMode;
+      float dstOffset[2];
+      float dstScale[2];
+      VkRect2D dstRect;
     };
 
     D3D11ImmediateContext*  m_ctx;
@@ -668,8 +671,15 @@ namespace dxvk {
     Rc<DxvkDevice>          m_device;
     Rc<DxvkShader>          m_vs;
     Rc<DxvkShader>          m_fs;
+    Rc<DxvkShader>          m_cs;
     Rc<DxvkBuffer>          m_ubo;
 
+    // Only accessed on the CS thread. Non-null if the
+    // current output is written by the compute shader.
+    Rc<DxvkImageView>       m_csOutputView;
+
+    std::unordered_map<VkFormat, bool> m_computeFormats;
+
     VkExtent2D m_dstExtent      = { 0u, 0u };
     float      m_dstSizeFact[2] = { 1.0f, 1.0f };
     bool       m_dstIsYCbCr     = false;
@@ -683,12 +693,16 @@ namespace dxvk {
 
     void BindOutputView(
             Rc<DxvkImageView>               View,
-            Rc<DxvkImageView>               FirstView);
+            Rc<DxvkImageView>               FirstView,
+            bool                            UseCompute);
 
     void BlitStream(
       const D3D11VideoProcessorStreamState* pStreamState,
       const D3D11_VIDEO_PROCESSOR_STREAM*   pStream);
 
+    bool CanUseComputeBlit(
+      const D3D11VideoProcessorView&        View);
+
     void CopyBaseImageToShadow(
       const D3D11VideoProcessorView&        View);
 
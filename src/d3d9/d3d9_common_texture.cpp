@@ -601,6 +601,17 @@ namespace dxvk {
 #ifdef D3D9_ALLOW_UNMAPPING
     if (m_device->GetOptions()->textureMemory != 0 && m_desc.Pool != D3DPOOL_DEFAULT)
       return D3D9_COMMON_TEXTURE_MAP_MODE_UNMAPPABLE;
+#else
+    // Block-compressed data generally does not compress any further,
+    // so keep those textures in regular mapped buffers.
+    if (m_device->GetOptions()->compressTextureMemory
+     && m_device->GetOptions()->textureMemory != 0
+     && m_desc.Pool != D3DPOOL_DEFAULT) {
+      const DxvkFormatInfo* formatInfo = lookupFormatInfo(m_mapping.FormatColor);
+
+      if (formatInfo && !formatInfo->flags.test(DxvkFormatFlag::BlockCompressed))
+        return D3D9_COMMON_TEXTURE_MAP_MODE_UNMAPPABLE;
+    }
 #endif
 
     if (m_desc.Pool == D3DPOOL_SYSTEMMEM || m_desc.Pool == D3DPOOL_SCRATCH)
@@ -257,6 +257,16 @@ namespace dxvk {
       m_data.Unmap();
     }
 
+    /**
+     * \brief Evicts locking data from memory
+     *
+     * Unmaps or compresses the data, depending on the platform.
+     * The data will be restored the next time it is accessed.
+     */
+    void EvictData() {
+      m_data.Evict();
+    }
+
     /**
      * \brief Destroys a buffer
      * Destroys mapping and staging buffers for a given subresource
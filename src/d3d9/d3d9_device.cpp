@@ -5412,6 +5412,23 @@ namespace dxvk {
 
       VkFormat packedDSFormat = GetPackedDepthStencilFormat(pDestTexture->Desc()->Format);
 
+      if (m_uploadBatchActive) {
+        // Defer the copy until all managed textures for
+        // the current draw have been processed.
+        auto& upload = m_uploadBatch.emplace_back();
+        upload.srcSlice       = std::move(slice.slice);
+        upload.srcTexture     = pSrcTexture;
+        upload.srcSubresource = SrcSubresource;
+        upload.dstImage       = image;
+        upload.dstLayers      = dstLayers;
+        upload.dstOffset      = alignedDestOffset;
+        upload.dstExtent      = alignedExtent;
+        upload.packedDSFormat = packedDSFormat;
+
+        UnmapTextures();
+        return;
+      }
+
       EmitCs([
         cSrcSlice       = slice.slice,
         cDstImage       = image,
@@ -6395,6 +6412,18 @@ namespace dxvk {
       if (cTracker && cTracker->needsAutoMarkers())
         ctx->endLatencyTracking(cTracker);
     });
+
+    // Feed measured idle times back into the flush heuristic
+    if (m_dxvkDevice->config().adaptiveFlush) {
+      GpuFlushFeedback feedback;
+      feedback.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+        dxvk::high_resolution_clock::now().time_since_epoch()).count();
+      feedback.gpuIdleTicks = m_dxvkDevice->getStatCtr(DxvkStatCounter::GpuIdleTicks);
+      feedback.csIdleTicks = m_dxvkDevice->getStatCtr(DxvkStatCounter::CsIdleTicks);
+      feedback.presentSyncTicks = m_dxvkDevice->getStatCtr(DxvkStatCounter::PresentSyncTicks);
+
+      m_flushTracker.notifyFrame(feedback);
+    }
   }
 
 
@@ -6679,6 +6708,10 @@ namespace dxvk {
 
 
   void D3D9DeviceEx::UploadManagedTexture(D3D9CommonTexture* pResource) {
+    // Coalesce copies for all dirty subresources, unless
+    // the caller is already recording a larger batch.
+    const bool ownsBatch = !std::exchange(m_uploadBatchActive, true);
+
     for (uint32_t subresource = 0; subresource < pResource->CountSubresources(); subresource++) {
       if (!pResource->NeedsUpload(subresource))
         continue;
@@ -6688,18 +6721,70 @@ namespace dxvk {
 
     pResource->ClearDirtyBoxes();
     pResource->ClearNeedsUpload();
+
+    if (ownsBatch)
+      FlushUploadBatch();
   }
 
 
   void D3D9DeviceEx::UploadManagedTextures(uint32_t mask) {
+    m_uploadBatchActive = true;
+
     // Guaranteed to not be nullptr...
     for (uint32_t texIdx : bit::BitMask(mask))
       UploadManagedTexture(GetCommonTexture(m_state.textures[texIdx]));
 
+    FlushUploadBatch();
+
     m_textureSlotTracking.needsUpload &= ~mask;
   }
 
 
+  void D3D9DeviceEx::FlushUploadBatch() {
+    m_uploadBatchActive = false;
+
+    if (m_uploadBatch.empty())
+      return;
+
+    VkDeviceSize byteCount = 0u;
+
+    small_vector<std::pair<D3D9CommonTexture*, UINT>, 16> mappings;
+
+    for (const auto& upload : m_uploadBatch) {
+      byteCount += upload.srcSlice.length();
+      mappings.push_back({ upload.srcTexture, upload.srcSubresource });
+    }
+
+    m_uploadBytes.fetch_add(byteCount, std::memory_order_relaxed);
+    m_uploadCopies.fetch_add(m_uploadBatch.size(), std::memory_order_relaxed);
+    m_uploadBatches.fetch_add(1u, std::memory_order_relaxed);
+
+    // Emit all copies as a single command. The context will record
+    // each copy into the init command buffer if the image has not been
+    // used in the current command list yet, so uploads that happen in
+    // the middle of a frame do not necessarily end the render pass.
+    EmitCs([
+      cUploads = std::move(m_uploadBatch)
+    ] (DxvkContext* ctx) {
+      for (const auto& upload : cUploads) {
+        ctx->copyBufferToImage(
+          upload.dstImage, upload.dstLayers,
+          upload.dstOffset, upload.dstExtent,
+          upload.srcSlice.buffer(), upload.srcSlice.offset(),
+          0, 0, upload.packedDSFormat);
+      }
+    });
+
+    // Track mapping buffer usage only after emitting the copies,
+    // in case a flush happened while the batch was being recorded.
+    for (const auto& mapping : mappings)
+      TrackTextureMappingBufferSequenceNumber(mapping.first, mapping.second);
+
+    m_uploadBatch.clear();
+    ConsiderFlush(GpuFlushType::ImplicitWeakHint);
+  }
+
+
   void D3D9DeviceEx::UpdateTextureTypeMismatchesForShader(const D3D9CommonShader* shader, uint32_t shaderSamplerMask, uint32_t shaderSamplerOffset) {
     const uint32_t stageCorrectedShaderSamplerMask = shaderSamplerMask << shaderSamplerOffset;
     if (unlikely(shader->GetInfo().majorVersion() < 2 || m_d3d9Options.forceSamplerTypeSpecConstants)) {
@@ -7885,7 +7970,11 @@ namespace dxvk {
   const D3D9CommonShader*                 pShaderModule) {
     auto shader = pShaderModule->GetShader();
 
-    if (unlikely(shader->needsCompile()))
+    // Shaders that failed to compile on a worker have no module.
+    // Binding null will make the backend skip affected draws.
+    if (unlikely(pShaderModule->HasFailed()))
+      Logger::debug(str::format("D3D9: Binding failed shader ", pShaderModule->GetName()));
+    else if (unlikely(shader->needsCompile()))
       m_dxvkDevice->requestCompileShader(shader);
 
     EmitCs([
@@ -7917,6 +8006,32 @@ namespace dxvk {
   }
 
 
+  template <D3D9ShaderType ShaderStage, typename T>
+  void D3D9DeviceEx::BindFFVariant(
+  const T&                                ShaderKey) {
+    const uint32_t stageIndex = uint32_t(ShaderStage);
+
+    // Read the counter before the look-up so that we
+    // do not miss a variant that finishes in between
+    m_ffVariantCount[stageIndex] = m_ffModules.GetCompletedVariantCount();
+
+    auto shader = m_ffModules.TryGetShaderModule(ShaderKey);
+    m_ffVariantPending[stageIndex] = shader == nullptr;
+
+    if (!shader) {
+      BindFFUbershader<ShaderStage>();
+      return;
+    }
+
+    EmitCs([
+      cShader = std::move(shader)
+    ] (DxvkContext* ctx) mutable {
+      constexpr VkShaderStageFlagBits stage = GetShaderStage(ShaderStage);
+      ctx->bindShader<stage>(std::move(cShader));
+    });
+  }
+
+
   void D3D9DeviceEx::BindInputLayout() {
     m_dirty.clr(D3D9DeviceDirtyFlag::InputLayout);
 
@@ -8282,9 +8397,19 @@ namespace dxvk {
     // Shader...
     const bool useUbershader = m_d3d9Options.ffUbershaderVS;
 
+    if (unlikely(m_ffVariantPending[uint32_t(D3D9ShaderType::VertexShader)])) {
+      if (m_ffModules.GetCompletedVariantCount() != m_ffVariantCount[uint32_t(D3D9ShaderType::VertexShader)])
+        m_dirty.set(D3D9DeviceDirtyFlag::FFVertexShader);
+    }
+
     if (useUbershader && m_dirty.test(D3D9DeviceDirtyFlag::FFVertexShader)) {
       m_dirty.clr(D3D9DeviceDirtyFlag::FFVertexShader);
       m_dirty.set(D3D9DeviceDirtyFlag::FFVertexData);
+
+      // Use a specialized shader if one is available, the
+      // uber shader is only used while it is being compiled.
+      if (m_d3d9Options.ffPrecompileVariants)
+        BindFFVariant<D3D9ShaderType::VertexShader>(BuildFFKeyVS(vertexBlendMode, indexedVertexBlend));
     } else if (m_dirty.test(D3D9DeviceDirtyFlag::FFVertexShader)) {
       m_dirty.clr(D3D9DeviceDirtyFlag::FFVertexShader);
 
@@ -8460,6 +8585,11 @@ namespace dxvk {
 
 
   void D3D9DeviceEx::UpdateFixedFunctionPS() {
+    if (unlikely(m_ffVariantPending[uint32_t(D3D9ShaderType::PixelShader)])) {
+      if (m_ffModules.GetCompletedVariantCount() != m_ffVariantCount[uint32_t(D3D9ShaderType::PixelShader)])
+        m_dirty.set(D3D9DeviceDirtyFlag::FFPixelShader);
+    }
+
     if (unlikely(!m_dirty.test(D3D9DeviceDirtyFlag::FFPixelShader) && !m_dirty.test(D3D9DeviceDirtyFlag::FFPixelData)))
       return;
 
@@ -8516,6 +8646,9 @@ namespace dxvk {
       if (dirty) {
         m_dirty.set(D3D9DeviceDirtyFlag::SpecializationEntries);
       }
+
+      if (m_d3d9Options.ffPrecompileVariants)
+        BindFFVariant<D3D9ShaderType::PixelShader>(key);
     } else if (m_dirty.test(D3D9DeviceDirtyFlag::FFPixelShader)) {
       m_dirty.clr(D3D9DeviceDirtyFlag::FFPixelShader);
 
@@ -9077,44 +9210,42 @@ namespace dxvk {
     // Will only be called inside the device lock
     void *ptr = pTexture->GetData(Subresource);
 
-#ifdef D3D9_ALLOW_UNMAPPING
     if (likely(pTexture->GetMapMode() == D3D9_COMMON_TEXTURE_MAP_MODE_UNMAPPABLE)) {
       m_mappedTextures.insert(pTexture);
     }
-#endif
 
     return ptr;
   }
 
   void D3D9DeviceEx::TouchMappedTexture(D3D9CommonTexture* pTexture) {
-#ifdef D3D9_ALLOW_UNMAPPING
     if (pTexture->GetMapMode() != D3D9_COMMON_TEXTURE_MAP_MODE_UNMAPPABLE)
       return;
 
     D3D9DeviceLock lock = LockDevice();
     m_mappedTextures.touch(pTexture);
-#endif
   }
 
   void D3D9DeviceEx::RemoveMappedTexture(D3D9CommonTexture* pTexture) {
-#ifdef D3D9_ALLOW_UNMAPPING
     if (pTexture->GetMapMode() != D3D9_COMMON_TEXTURE_MAP_MODE_UNMAPPABLE)
       return;
 
     D3D9DeviceLock lock = LockDevice();
     m_mappedTextures.remove(pTexture);
-#endif
   }
 
   void D3D9DeviceEx::UnmapTextures() {
     // Will only be called inside the device lock
 
-#ifdef D3D9_ALLOW_UNMAPPING
-    uint32_t mappedMemory = m_memoryAllocator.MappedMemory();
-    if (likely(mappedMemory < uint32_t(m_d3d9Options.textureMemory)))
+    // Unmappable textures only exist on 32-bit, or with
+    // texture memory compression enabled on 64-bit.
+    if (likely(m_mappedTextures.size() == 0))
+      return;
+
+    size_t mappedMemory = m_memoryAllocator.MappedMemory();
+    if (likely(mappedMemory < size_t(m_d3d9Options.textureMemory)))
       return;
 
-    uint32_t threshold = (m_d3d9Options.textureMemory / 4) * 3;
+    size_t threshold = (size_t(m_d3d9Options.textureMemory) / 4) * 3;
 
     auto iter = m_mappedTextures.leastRecentlyUsedIter();
     while (m_memoryAllocator.MappedMemory() >= threshold && iter != m_mappedTextures.leastRecentlyUsedEndIter()) {
@@ -9122,11 +9253,10 @@ namespace dxvk {
         iter++;
         continue;
       }
-      (*iter)->UnmapData();
+      (*iter)->EvictData();
 
       iter = m_mappedTextures.remove(iter);
     }
-#endif
   }
 
   ////////////////////////////////////
@@ -9228,13 +9358,44 @@ namespace dxvk {
 
 
   void D3D9DeviceEx::BindSpecConstants() {
-    if (!m_dirty.test(D3D9DeviceDirtyFlag::SpecializationEntries))
-      return;
+    // Only pass the spec constant bits that the bound shaders actually
+    // read to the backend, so that state changes which do not affect
+    // the current shaders do not create redundant pipeline variants.
+    // Fixed-function shaders are generated per state and use all bits.
+    D3D9SpecConstantMask mask;
+
+    if (UseProgrammableVS())
+      mask = GetCommonShader(m_state.vertexShader)->GetSpecConstantMask();
+    else
+      mask.fill(~0u);
 
-    EmitCs([cSpecInfo = m_specInfo](DxvkContext* ctx) {
-      for (size_t i = 0; i < cSpecInfo.data.size(); i++)
-        ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_GRAPHICS, i, cSpecInfo.data[i]);
-    });
+    if (UseProgrammablePS()) {
+      const auto& psMask = GetCommonShader(m_state.pixelShader)->GetSpecConstantMask();
+
+      for (size_t i = 0; i < mask.size(); i++)
+        mask[i] |= psMask[i];
+    } else {
+      mask.fill(~0u);
+    }
+
+    bool dirty = m_dirty.test(D3D9DeviceDirtyFlag::SpecializationEntries);
+    bool changed = dirty;
+
+    for (size_t i = 0; i < mask.size(); i++) {
+      uint32_t value = m_specInfo.data[i] & mask[i];
+      changed |= m_specConstants[i] != value;
+      m_specConstants[i] = value;
+    }
+
+    if (changed) {
+      EmitCs([cSpecConstants = m_specConstants](DxvkContext* ctx) {
+        for (size_t i = 0; i < cSpecConstants.size(); i++)
+          ctx->setSpecConstant(VK_PIPELINE_BIND_POINT_GRAPHICS, i, cSpecConstants[i]);
+      });
+    }
+
+    if (!dirty)
+      return;
 
     // Write spec constants into buffer for fast-linked pipelines to use it.
     if (m_usingGraphicsPipelines) {
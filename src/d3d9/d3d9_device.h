@@ -105,6 +105,35 @@ namespace dxvk {
     void*           mapPtr = nullptr;
   };
 
+  /**
+   * \brief Pending managed texture upload
+   *
+   * Buffer to image copy recorded while uploading managed
+   * textures, so that all copies needed for a draw can be
+   * submitted to the CS thread as one batch.
+   */
+  struct D3D9ImageUpload {
+    DxvkBufferSlice           srcSlice;
+    D3D9CommonTexture*        srcTexture;
+    UINT                      srcSubresource;
+    Rc<DxvkImage>             dstImage;
+    VkImageSubresourceLayers  dstLayers;
+    VkOffset3D                dstOffset;
+    VkExtent3D                dstExtent;
+    VkFormat                  packedDSFormat;
+  };
+
+  /**
+   * \brief Managed texture upload statistics
+   *
+   * Running totals, the HUD computes per-frame values.
+   */
+  struct D3D9UploadStats {
+    uint64_t bytes   = 0u;
+    uint64_t copies  = 0u;
+    uint64_t batches = 0u;
+  };
+
   struct D3D9TextureSlotTracking {
     /* Pixel shaders can access 16 textures/samplers.
      * Then there's 1 dmap texture/sampler.
@@ -982,6 +1011,8 @@ namespace dxvk {
 
     void UploadManagedTextures(uint32_t mask);
 
+    void FlushUploadBatch();
+
     void GenerateTextureMips(uint32_t mask);
 
     void MarkTextureMipsDirty(D3D9CommonTexture* pResource);
@@ -1092,6 +1123,10 @@ namespace dxvk {
     template <D3D9ShaderType ShaderStage>
     void BindFFUbershader();
 
+    template <D3D9ShaderType ShaderStage, typename T>
+    void BindFFVariant(
+    const T&                                ShaderKey);
+
     void BindInputLayout();
 
     void BindVertexBuffer(
@@ -1247,6 +1282,17 @@ namespace dxvk {
       return m_swvpEmulator.GetShaderCount();
     }
 
+    /**
+     * \brief Returns managed texture upload statistics
+     */
+    D3D9UploadStats GetUploadStats() const {
+      D3D9UploadStats stats;
+      stats.bytes   = m_uploadBytes.load(std::memory_order_relaxed);
+      stats.copies  = m_uploadCopies.load(std::memory_order_relaxed);
+      stats.batches = m_uploadBatches.load(std::memory_order_relaxed);
+      return stats;
+    }
+
     void InjectCsChunk(
             DxvkCsChunkRef&&            Chunk,
             bool                        Synchronize);
@@ -1652,11 +1698,26 @@ namespace dxvk {
     D3D9VBSlotTracking              m_vbSlotTracking;
 
     D3D9SpecializationInfo          m_specInfo = D3D9SpecializationInfo();
+    D3D9SpecConstantMask            m_specConstants = { };
 
     bool                            m_isSWVP;
     bool                            m_isD3D8Compatible;
     bool                            m_ffZTest          = false;
 
+    // Fixed-function variants that were still being compiled when
+    // the state was last updated, per stage. The uber shader is
+    // bound until the completed variant count changes.
+    std::array<bool, 2>             m_ffVariantPending = { };
+    std::array<uint32_t, 2>         m_ffVariantCount   = { };
+
+    // Managed texture copies that have not been emitted yet
+    std::vector<D3D9ImageUpload>    m_uploadBatch;
+    bool                            m_uploadBatchActive = false;
+
+    std::atomic<uint64_t>           m_uploadBytes   = { 0u };
+    std::atomic<uint64_t>           m_uploadCopies  = { 0u };
+    std::atomic<uint64_t>           m_uploadBatches = { 0u };
+
     // the enablement of below features is tracked independently
     // of render states both due to complexity and to avoid
     // incurring overhead on all render state changes
@@ -1705,9 +1766,7 @@ namespace dxvk {
 
     D3D9SwapChainEx*                m_mostRecentlyUsedSwapchain = nullptr;
 
-#ifdef D3D9_ALLOW_UNMAPPING
     lru_list<D3D9CommonTexture*>    m_mappedTextures;
-#endif
 
     // m_state should be declared last (i.e. freed first), because it
     // references objects that can call back into the device when freed.
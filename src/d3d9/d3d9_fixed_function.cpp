@@ -5,13 +5,16 @@
 #include "d3d9_spec_constants.h"
 
 #include "../dxvk/dxvk_hash.h"
+#include "../dxvk/dxvk_shader_cache.h"
 #include "../dxvk/dxvk_shader_spirv.h"
 
 #include "../util/util_small_vector.h"
+#include "../util/util_time.h"
 
 #include "../spirv/spirv_module.h"
 
 #include <cfloat>
+#include <optional>
 
 #include <d3d9_fixed_function_vert.h>
 #include <d3d9_fixed_function_frag.h>
@@ -816,7 +819,7 @@ namespace dxvk {
       const std::string&             Name,
             D3D9FixedFunctionOptions Options);
 
-    Rc<DxvkShader> compile();
+    Rc<DxvkSpirvShader> compile();
 
     DxsoIsgn isgn() { return m_isgn; }
 
@@ -923,7 +926,7 @@ namespace dxvk {
   , m_options     ( Options ) { }
 
 
-  Rc<DxvkShader> D3D9FFShaderCompiler::compile() {
+  Rc<DxvkSpirvShader> D3D9FFShaderCompiler::compile() {
     m_floatType  = m_module.defFloatType(32);
     m_uint32Type = m_module.defIntType(32, 0);
     m_vec4Type   = m_module.defVectorType(m_floatType, 4);
@@ -2692,20 +2695,25 @@ namespace dxvk {
   }
 
 
-  D3D9FFShader::D3D9FFShader(
-          D3D9DeviceEx*         pDevice,
-    const D3D9FFShaderKeyVS&    Key) {
+  template <typename T>
+  static std::string GetShaderName(const T& Key) {
+    VkShaderStageFlagBits stage = std::is_same_v<T, D3D9FFShaderKeyVS>
+      ? VK_SHADER_STAGE_VERTEX_BIT
+      : VK_SHADER_STAGE_FRAGMENT_BIT;
+
     Sha1Hash hash = Sha1Hash::compute(&Key, sizeof(Key));
-    DxvkShaderHash shaderKey(VK_SHADER_STAGE_VERTEX_BIT,  0u, hash.digest(), hash.digestLength());
+    DxvkShaderHash shaderKey(stage, 0u, hash.digest(), hash.digestLength());
+
+    return str::format("FF_", shaderKey.toString());
+  }
 
-    std::string name = str::format("FF_", shaderKey.toString());
 
-    D3D9FFShaderCompiler compiler(
-      pDevice->GetDXVKDevice(),
-      Key, name,
-      pDevice->GetOptions());
+  D3D9FFShader::D3D9FFShader(
+          D3D9DeviceEx*         pDevice,
+    const D3D9FFShaderKeyVS&    Key) {
+    std::string name = GetShaderName(Key);
 
-    m_shader = compiler.compile();
+    CreateShader(pDevice, Key, name);
 
     Dump(pDevice, Key, name);
 
@@ -2716,17 +2724,9 @@ namespace dxvk {
   D3D9FFShader::D3D9FFShader(
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyFS&    Key) {
-    Sha1Hash hash = Sha1Hash::compute(&Key, sizeof(Key));
-    DxvkShaderHash shaderKey(VK_SHADER_STAGE_FRAGMENT_BIT, 0u, hash.digest(), hash.digestLength());
-
-    std::string name = str::format("FF_", shaderKey.toString());
+    std::string name = GetShaderName(Key);
 
-    D3D9FFShaderCompiler compiler(
-      pDevice->GetDXVKDevice(),
-      Key, name,
-      pDevice->GetOptions());
-
-    m_shader = compiler.compile();
+    CreateShader(pDevice, Key, name);
 
     Dump(pDevice, Key, name);
 
@@ -2880,6 +2880,46 @@ namespace dxvk {
   }
 
 
+  template <typename T>
+  static DxvkShaderCache::SpirvKey GetShaderCacheKey(const T& Key, const std::string& Name, const D3D9FixedFunctionOptions& Options) {
+    DxvkShaderCache::SpirvKey cacheKey;
+    cacheKey.name = Name;
+    cacheKey.add(Key);
+    cacheKey.add(Options.forceSampleRateShading);
+    return cacheKey;
+  }
+
+
+  template <typename T>
+  void D3D9FFShader::CreateShader(D3D9DeviceEx* pDevice, const T& Key, const std::string& Name) {
+    D3D9FixedFunctionOptions options(pDevice->GetOptions());
+
+    // Shader keys are memcmp-safe, so we can use them for cache look-ups as-is
+    Rc<DxvkShaderCache> shaderCache = pDevice->GetDXVKDevice()->getShaderCache();
+    DxvkShaderCache::SpirvKey cacheKey;
+
+    if (shaderCache) {
+      cacheKey = GetShaderCacheKey(Key, Name, options);
+
+      std::vector<uint8_t> apiData;
+      m_shader = shaderCache->lookupSpirvShader(cacheKey, apiData);
+    }
+
+    if (!m_shader) {
+      D3D9FFShaderCompiler compiler(
+        pDevice->GetDXVKDevice(),
+        Key, Name, options);
+
+      Rc<DxvkSpirvShader> shader = compiler.compile();
+
+      if (shaderCache)
+        shaderCache->addSpirvShader(cacheKey, shader, std::vector<uint8_t>());
+
+      m_shader = std::move(shader);
+    }
+  }
+
+
   template <typename T>
   void D3D9FFShader::Dump(D3D9DeviceEx* pDevice, const T& Key, const std::string& Name) {
     const std::string& dumpPath = pDevice->GetOptions()->shaderDumpPath;
@@ -2895,24 +2935,55 @@ namespace dxvk {
 
 
   D3D9FFShaderModuleSet::D3D9FFShaderModuleSet(D3D9DeviceEx* pDevice)
-    : m_vsUbershader(pDevice, D3D9ShaderType::VertexShader)
-    , m_fsUbershader(pDevice, D3D9ShaderType::PixelShader) {}
+    : m_device(pDevice)
+    , m_vsUbershader(pDevice, D3D9ShaderType::VertexShader)
+    , m_fsUbershader(pDevice, D3D9ShaderType::PixelShader) {
+    const D3D9Options* options = pDevice->GetOptions();
+
+    // Compile variants used in previous runs ahead of time so
+    // that we rarely have to fall back to the ubershader.
+    if (options->ffPrecompileVariants) {
+      if (options->ffUbershaderVS)
+        PrecompileVariants<D3D9FFShaderKeyVS>("FF_vs.");
+
+      if (options->ffUbershaderFS)
+        PrecompileVariants<D3D9FFShaderKeyFS>("FF_fs.");
+    }
+
+    if (!options->ffShaderCorpusPath.empty())
+      D3D9FFShaderCorpus::Generate(pDevice, options->ffShaderCorpusPath);
+  }
+
+
+  D3D9FFShaderModuleSet::~D3D9FFShaderModuleSet() {
+    { std::unique_lock lock(m_workerMutex);
+      m_workerStopped = true;
+      m_workerCond.notify_one();
+    }
+
+    if (m_worker.joinable())
+      m_worker.join();
+  }
 
 
   D3D9FFShader D3D9FFShaderModuleSet::GetShaderModule(
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyVS&    ShaderKey) {
     // Use the shader's unique key for the lookup
-    auto entry = m_vsModules.find(ShaderKey);
-    if (entry != m_vsModules.end())
-      return entry->second;
+    { std::unique_lock lock(m_mutex);
+
+      auto entry = m_vsModules.find(ShaderKey);
+      if (entry != m_vsModules.end())
+        return entry->second;
+    }
 
+    // Don't hold the lock while compiling, the background
+    // worker may use this to compile a different variant.
     D3D9FFShader shader(
       pDevice, ShaderKey);
 
-    m_vsModules.insert({ShaderKey, shader});
-
-    return shader;
+    std::unique_lock lock(m_mutex);
+    return m_vsModules.insert({ShaderKey, shader}).first->second;
   }
 
 
@@ -2920,16 +2991,434 @@ namespace dxvk {
           D3D9DeviceEx*         pDevice,
     const D3D9FFShaderKeyFS&    ShaderKey) {
     // Use the shader's unique key for the lookup
-    auto entry = m_fsModules.find(ShaderKey);
-    if (entry != m_fsModules.end())
-      return entry->second;
+    { std::unique_lock lock(m_mutex);
+
+      auto entry = m_fsModules.find(ShaderKey);
+      if (entry != m_fsModules.end())
+        return entry->second;
+    }
 
     D3D9FFShader shader(
       pDevice, ShaderKey);
 
-    m_fsModules.insert({ShaderKey, shader});
+    std::unique_lock lock(m_mutex);
+    return m_fsModules.insert({ShaderKey, shader}).first->second;
+  }
+
+
+  Rc<DxvkShader> D3D9FFShaderModuleSet::TryGetShaderModule(
+    const D3D9FFShaderKeyVS&    ShaderKey) {
+    { std::unique_lock lock(m_mutex);
+
+      auto entry = m_vsModules.find(ShaderKey);
+      if (entry != m_vsModules.end())
+        return entry->second.GetShader();
+    }
+
+    EnqueueVariant(ShaderKey);
+    return nullptr;
+  }
+
+
+  Rc<DxvkShader> D3D9FFShaderModuleSet::TryGetShaderModule(
+    const D3D9FFShaderKeyFS&    ShaderKey) {
+    { std::unique_lock lock(m_mutex);
+
+      auto entry = m_fsModules.find(ShaderKey);
+      if (entry != m_fsModules.end())
+        return entry->second.GetShader();
+    }
+
+    EnqueueVariant(ShaderKey);
+    return nullptr;
+  }
+
+
+  template <typename T>
+  void D3D9FFShaderModuleSet::EnqueueVariant(
+    const T&                    ShaderKey) {
+    std::unique_lock lock(m_workerMutex);
+
+    bool inserted;
+
+    if constexpr (std::is_same_v<T, D3D9FFShaderKeyVS>)
+      inserted = m_vsPending.insert(ShaderKey).second;
+    else
+      inserted = m_fsPending.insert(ShaderKey).second;
+
+    // Variants that failed to compile remain in the
+    // pending set, so we will never retry them.
+    if (!inserted)
+      return;
+
+    if constexpr (std::is_same_v<T, D3D9FFShaderKeyVS>)
+      m_vsQueue.push(ShaderKey);
+    else
+      m_fsQueue.push(ShaderKey);
+
+    if (!m_worker.joinable()) {
+      m_worker = dxvk::thread([this] { RunWorker(); });
+      m_worker.set_priority(ThreadPriority::Lowest);
+    }
+
+    m_workerCond.notify_one();
+  }
+
+
+  template <typename T>
+  void D3D9FFShaderModuleSet::PrecompileVariants(
+    const std::string&          Prefix) {
+    Rc<DxvkShaderCache> shaderCache = m_device->GetDXVKDevice()->getShaderCache();
+
+    if (!shaderCache)
+      return;
+
+    D3D9FixedFunctionOptions options(m_device->GetOptions());
+
+    uint32_t variantCount = 0u;
+
+    for (const auto& cacheKey : shaderCache->getSpirvKeys(Prefix)) {
+      // The cache key stores the raw shader key, followed by the
+      // compile options. Skip any variants that we would compile
+      // differently, since those will never be used.
+      T shaderKey;
+
+      if (cacheKey.data.size() != sizeof(shaderKey) + sizeof(options.forceSampleRateShading))
+        continue;
+
+      std::memcpy(&shaderKey, cacheKey.data.data(), sizeof(shaderKey));
+
+      if (cacheKey.data != GetShaderCacheKey(shaderKey, cacheKey.name, options).data)
+        continue;
+
+      EnqueueVariant(shaderKey);
+      variantCount += 1u;
+    }
+
+    if (variantCount)
+      Logger::info(str::format("D3D9: Precompiling ", variantCount, " fixed-function variants"));
+  }
+
+
+  void D3D9FFShaderModuleSet::RunWorker() {
+    env::setThreadName("dxvk-ff-shader");
+
+    while (true) {
+      std::optional<D3D9FFShaderKeyVS> vsKey;
+      std::optional<D3D9FFShaderKeyFS> fsKey;
+
+      { std::unique_lock lock(m_workerMutex);
+
+        m_workerCond.wait(lock, [this] {
+          return m_workerStopped || !m_vsQueue.empty() || !m_fsQueue.empty();
+        });
+
+        if (m_workerStopped)
+          return;
+
+        if (!m_vsQueue.empty()) {
+          vsKey = m_vsQueue.front();
+          m_vsQueue.pop();
+        } else {
+          fsKey = m_fsQueue.front();
+          m_fsQueue.pop();
+        }
+      }
+
+      try {
+        if (vsKey)
+          GetShaderModule(m_device, *vsKey);
+        else
+          GetShaderModule(m_device, *fsKey);
+      } catch (const DxvkError& e) {
+        Logger::err(str::format("Failed to compile fixed-function variant: ", e.message()));
+        continue;
+      } catch (const std::exception& e) {
+        Logger::err(str::format("Failed to compile fixed-function variant: ", e.what()));
+        continue;
+      } catch (...) {
+        Logger::err("Failed to compile fixed-function variant");
+        continue;
+      }
+
+      { std::unique_lock lock(m_workerMutex);
+
+        if (vsKey)
+          m_vsPending.erase(*vsKey);
+        else
+          m_fsPending.erase(*fsKey);
+      }
+
+      m_completedVariants.fetch_add(1u, std::memory_order_release);
+    }
+  }
+
+
+  static D3D9FFShaderKeyVS CreateCorpusKeyVS(
+          bool                  PositionT,
+          uint32_t              ColorCount,
+          bool                  Lighting,
+          uint32_t              LightCount,
+          uint32_t              TexcoordCount) {
+    D3D9FFShaderKeyVS key;
+
+    auto& c = key.Data.Contents;
+    c.VertexHasPositionT = PositionT;
+    c.VertexHasColor0    = ColorCount >= 1u;
+    c.VertexHasColor1    = ColorCount >= 2u;
+
+    // Mirrors default material sources with D3DRS_COLORVERTEX
+    c.UseLighting        = Lighting && !PositionT;
+    c.LightCount         = c.UseLighting ? LightCount : 0u;
+    c.DiffuseSource      = c.UseLighting && c.VertexHasColor0 ? D3DMCS_COLOR1 : D3DMCS_MATERIAL;
+    c.SpecularSource     = c.UseLighting && c.VertexHasColor1 ? D3DMCS_COLOR2 : D3DMCS_MATERIAL;
+
+    for (uint32_t i = 0; i < TexcoordCount; i++) {
+      c.TexcoordIndices        |= i  << (i * 3);
+      c.VertexTexcoordDeclMask |= 2u << (i * 3);
+    }
+
+    return key;
+  }
+
+
+  static D3D9FFShaderKeyFS CreateCorpusKeyFS(
+          uint32_t              StageCount,
+          D3DTEXTUREOP          ColorOp,
+          uint32_t              ColorArg0,
+          uint32_t              ColorArg1,
+          uint32_t              ColorArg2) {
+    D3D9FFShaderKeyFS key;
+
+    for (uint32_t i = 0; i < StageCount; i++) {
+      auto& stage = key.Stages[i].Contents;
+      stage.ColorOp   = ColorOp;
+      stage.ColorArg0 = ColorArg0;
+      stage.ColorArg1 = ColorArg1;
+      stage.ColorArg2 = ColorArg2;
+      stage.AlphaOp   = D3DTOP_MODULATE;
+      stage.AlphaArg1 = D3DTA_TEXTURE;
+      stage.AlphaArg2 = D3DTA_CURRENT;
+    }
+
+    return key;
+  }
+
+
+  template <typename T>
+  static void GenerateCorpusVariants(
+          D3D9DeviceEx*         pDevice,
+    const std::vector<T>&       Keys,
+    const char*                 StageName,
+          std::ostream&         Report) {
+    D3D9FixedFunctionOptions options(pDevice->GetOptions());
+
+    const std::string& dumpPath = pDevice->GetOptions()->shaderDumpPath;
+
+    high_resolution_clock::duration totalTime = { };
+    size_t totalSize = 0u;
+    size_t totalInstructions = 0u;
+    uint32_t failedCount = 0u;
+
+    for (const auto& key : Keys) {
+      std::string name = GetShaderName(key);
+      Rc<DxvkSpirvShader> shader;
+
+      auto t0 = high_resolution_clock::now();
+
+      try {
+        D3D9FFShaderCompiler compiler(
+          pDevice->GetDXVKDevice(),
+          key, name, options);
+
+        shader = compiler.compile();
+      } catch (const DxvkError& e) {
+        Logger::err(str::format("Failed to generate fixed-function variant ", name, ": ", e.message()));
+        failedCount += 1u;
+        continue;
+      }
+
+      auto t1 = high_resolution_clock::now();
+
+      SpirvCodeBuffer code = shader->getRawCode();
+      size_t instructionCount = 0u;
+
+      for ([[maybe_unused]] auto ins : code)
+        instructionCount += 1u;
+
+      Report << StageName << "," << name
+             << "," << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count()
+             << "," << code.size()
+             << "," << instructionCount << "\n";
+
+      if (!dumpPath.empty()) {
+        std::ofstream dumpStream(
+          str::topath(str::format(dumpPath, "/", name, ".spv").c_str()).c_str(),
+          std::ios_base::binary | std::ios_base::trunc);
+
+        shader->dump(dumpStream);
+      }
+
+      totalTime += t1 - t0;
+      totalSize += code.size();
+      totalInstructions += instructionCount;
+    }
+
+    Logger::info(str::format("D3D9: Generated ", Keys.size() - failedCount, " fixed-function ", StageName,
+      " variants in ", std::chrono::duration_cast<std::chrono::milliseconds>(totalTime).count(), " ms",
+      " (", totalSize, " bytes, ", totalInstructions, " instructions, ", failedCount, " failed)"));
+  }
+
+
+  void D3D9FFShaderCorpus::Generate(
+          D3D9DeviceEx*         pDevice,
+    const std::string&          Path) {
+    std::ofstream report(str::topath(Path.c_str()).c_str(),
+      std::ios_base::binary | std::ios_base::trunc);
+
+    if (!report) {
+      Logger::warn(str::format("D3D9: Failed to create fixed-function corpus report: ", Path));
+      return;
+    }
+
+    report << "stage,name,time_us,size_bytes,instructions\n";
+
+    GenerateCorpusVariants(pDevice, EnumerateKeysVS(), "vs", report);
+    GenerateCorpusVariants(pDevice, EnumerateKeysFS(), "fs", report);
+  }
+
+
+  std::vector<D3D9FFShaderKeyVS> D3D9FFShaderCorpus::EnumerateKeysVS() {
+    std::vector<D3D9FFShaderKeyVS> keys;
+
+    // Common vertex formats, with and without lighting
+    for (uint32_t positionT = 0u; positionT < 2u; positionT++) {
+      for (uint32_t colorCount = 0u; colorCount < 3u; colorCount++) {
+        for (uint32_t lightCount : { 0u, 1u, 3u, caps::MaxEnabledLights }) {
+          if (positionT && lightCount)
+            continue;
+
+          for (uint32_t texcoordCount : { 0u, 1u, 2u, 4u })
+            keys.push_back(CreateCorpusKeyVS(positionT, colorCount, lightCount != 0u, lightCount, texcoordCount));
+        }
+      }
+    }
+
+    // Vary individual features on top of a typical lit vertex format
+    const D3D9FFShaderKeyVS base = CreateCorpusKeyVS(false, 1u, true, 1u, 1u);
+
+    auto addVariant = [&] (auto&& fn) {
+      D3D9FFShaderKeyVS key = base;
+      fn(key.Data.Contents);
+      keys.push_back(key);
+    };
+
+    addVariant([] (auto& c) { c.LightCount = 0u; });
+    addVariant([] (auto& c) { c.NormalizeNormals = 1u; });
+    addVariant([] (auto& c) { c.LocalViewer = 1u; });
+    addVariant([] (auto& c) { c.SpecularEnabled = 1u; });
+    addVariant([] (auto& c) { c.SpecularEnabled = 1u; c.LocalViewer = 1u; c.NormalizeNormals = 1u; });
+    addVariant([] (auto& c) {
+      c.DiffuseSource  = D3DMCS_COLOR1;
+      c.AmbientSource  = D3DMCS_COLOR1;
+      c.SpecularSource = D3DMCS_COLOR1;
+      c.EmissiveSource = D3DMCS_COLOR1;
+    });
+    addVariant([] (auto& c) { c.VertexHasFog = 1u; });
+    addVariant([] (auto& c) { c.RangeFog = 1u; });
+    addVariant([] (auto& c) { c.VertexHasPointSize = 1u; });
+    addVariant([] (auto& c) { c.VertexClipping = 1u; });
+
+    for (uint32_t blendCount = D3DVBF_1WEIGHTS; blendCount <= D3DVBF_3WEIGHTS; blendCount++) {
+      for (uint32_t indexed = 0u; indexed < 2u; indexed++) {
+        addVariant([=] (auto& c) {
+          c.VertexBlendMode    = D3D9FF_VertexBlendMode_Normal;
+          c.VertexBlendIndexed = indexed;
+          c.VertexBlendCount   = blendCount;
+        });
+      }
+    }
+
+    addVariant([] (auto& c) {
+      c.VertexBlendMode    = D3D9FF_VertexBlendMode_Normal;
+      c.VertexBlendIndexed = 1u;
+      c.VertexBlendCount   = D3DVBF_0WEIGHTS;
+    });
+
+    addVariant([] (auto& c) { c.VertexBlendMode = D3D9FF_VertexBlendMode_Tween; });
+
+    for (uint32_t texgen : { D3DTSS_TCI_CAMERASPACENORMAL, D3DTSS_TCI_CAMERASPACEPOSITION,
+                             D3DTSS_TCI_CAMERASPACEREFLECTIONVECTOR, D3DTSS_TCI_SPHEREMAP })
+      addVariant([=] (auto& c) { c.TexcoordFlags = (texgen & TCIMask) >> TCIOffset; });
+
+    for (uint32_t transform : { D3DTTFF_COUNT2, D3DTTFF_COUNT3, D3DTTFF_COUNT4 })
+      addVariant([=] (auto& c) { c.TransformFlags = transform; });
+
+    return keys;
+  }
+
+
+  std::vector<D3D9FFShaderKeyFS> D3D9FFShaderCorpus::EnumerateKeysFS() {
+    struct ColorOpInfo {
+      D3DTEXTUREOP op;
+      uint32_t     arg0;
+      uint32_t     arg1;
+      uint32_t     arg2;
+    };
+
+    static const std::array<ColorOpInfo, 19> s_colorOps = {{
+      { D3DTOP_MODULATE,                  D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_MODULATE2X,                D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_MODULATE4X,                D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_SELECTARG1,                D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_SELECTARG2,                D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_DIFFUSE  },
+      { D3DTOP_ADD,                       D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_ADDSIGNED,                 D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_ADDSMOOTH,                 D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_SUBTRACT,                  D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_BLENDDIFFUSEALPHA,         D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_BLENDTEXTUREALPHA,         D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_BLENDFACTORALPHA,          D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_BLENDCURRENTALPHA,         D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_MODULATEALPHA_ADDCOLOR,    D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_BUMPENVMAP,                D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_BUMPENVMAPLUMINANCE,       D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_DOTPRODUCT3,               D3DTA_CURRENT, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_MULTIPLYADD,               D3DTA_DIFFUSE, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+      { D3DTOP_LERP,                      D3DTA_TFACTOR, D3DTA_TEXTURE,  D3DTA_CURRENT  },
+    }};
+
+    std::vector<D3D9FFShaderKeyFS> keys;
+
+    // Fragment shader with all stages disabled
+    keys.emplace_back();
+
+    for (uint32_t stageCount : { 1u, 2u, 4u, caps::TextureStageCount }) {
+      for (const auto& info : s_colorOps)
+        keys.push_back(CreateCorpusKeyFS(stageCount, info.op, info.arg0, info.arg1, info.arg2));
+    }
+
+    // Vary individual features on top of a typical two-stage setup
+    const D3D9FFShaderKeyFS base = CreateCorpusKeyFS(2u, D3DTOP_MODULATE, D3DTA_CURRENT, D3DTA_TEXTURE, D3DTA_CURRENT);
+
+    auto addVariant = [&] (auto&& fn) {
+      D3D9FFShaderKeyFS key = base;
+      fn(key.Stages);
+      keys.push_back(key);
+    };
 
-    return shader;
+    addVariant([] (auto& s) { s[0].Contents.GlobalSpecularEnable = 1u; });
+    addVariant([] (auto& s) { s[0].Contents.ColorArg1 = D3DTA_TEXTURE | D3DTA_COMPLEMENT; });
+    addVariant([] (auto& s) { s[0].Contents.ColorArg1 = D3DTA_TEXTURE | D3DTA_ALPHAREPLICATE; });
+    addVariant([] (auto& s) { s[1].Contents.ColorArg2 = D3DTA_SPECULAR; });
+    addVariant([] (auto& s) { s[1].Contents.ColorArg2 = D3DTA_TFACTOR; });
+    addVariant([] (auto& s) { s[1].Contents.AlphaOp = D3DTOP_DISABLE; });
+    addVariant([] (auto& s) {
+      s[0].Contents.ResultIsTemp = 1u;
+      s[1].Contents.ColorArg2 = D3DTA_TEMP;
+    });
+
+    return keys;
   }
 
 
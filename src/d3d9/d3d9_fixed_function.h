@@ -10,8 +10,13 @@
 
 #include "../dxso/dxso_isgn.h"
 
+#include "../util/thread.h"
+
+#include <queue>
 #include <utility>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace dxvk {
 
@@ -146,6 +151,9 @@ namespace dxvk {
     template <typename T>
     void Dump(D3D9DeviceEx* pDevice, const T& Key, const std::string& Name);
 
+    template <typename T>
+    void CreateShader(D3D9DeviceEx* pDevice, const T& Key, const std::string& Name);
+
     Rc<DxvkShader> GetShader() const {
       return m_shader;
     }
@@ -157,6 +165,47 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Fixed-function shader corpus
+   *
+   * Generates a representative set of fixed-function shader
+   * variants and records the generation time, SPIR-V size and
+   * instruction count for each of them, so that changes to the
+   * fixed-function shader generator can be measured without
+   * running a game.
+   */
+  class D3D9FFShaderCorpus {
+
+  public:
+
+    /**
+     * \brief Generates all variants and writes a report
+     *
+     * Variants are generated directly, bypassing the shader
+     * cache. If a shader dump path is set, generated modules
+     * are also dumped so that they can be validated offline.
+     * \param [in] pDevice The device
+     * \param [in] Path Path to the CSV report file
+     */
+    static void Generate(
+            D3D9DeviceEx*         pDevice,
+      const std::string&          Path);
+
+    /**
+     * \brief Enumerates vertex shader keys
+     * \returns Representative set of vertex shader keys
+     */
+    static std::vector<D3D9FFShaderKeyVS> EnumerateKeysVS();
+
+    /**
+     * \brief Enumerates fragment shader keys
+     * \returns Representative set of fragment shader keys
+     */
+    static std::vector<D3D9FFShaderKeyFS> EnumerateKeysFS();
+
+  };
+
+
   class D3D9FFShaderModuleSet : public RcObject {
 
   public:
@@ -165,6 +214,8 @@ namespace dxvk {
 
     explicit D3D9FFShaderModuleSet(D3D9DeviceEx* pDevice);
 
+    ~D3D9FFShaderModuleSet();
+
     D3D9FFShader GetShaderModule(
             D3D9DeviceEx*         pDevice,
       const D3D9FFShaderKeyVS&    ShaderKey);
@@ -173,6 +224,32 @@ namespace dxvk {
             D3D9DeviceEx*         pDevice,
       const D3D9FFShaderKeyFS&    ShaderKey);
 
+    /**
+     * \brief Looks up specialized shader variant
+     *
+     * If the variant has not been compiled yet, it will be
+     * queued up for compilation on a background thread, and
+     * the caller is expected to use the ubershader instead.
+     * \param [in] ShaderKey Fixed-function shader key
+     * \returns The variant, or \c nullptr if it is pending
+     */
+    Rc<DxvkShader> TryGetShaderModule(
+      const D3D9FFShaderKeyVS&    ShaderKey);
+
+    Rc<DxvkShader> TryGetShaderModule(
+      const D3D9FFShaderKeyFS&    ShaderKey);
+
+    /**
+     * \brief Queries number of finished background compiles
+     *
+     * Can be used to check whether a pending variant may
+     * have become available without looking it up again.
+     * \returns Number of variants compiled in the background
+     */
+    uint32_t GetCompletedVariantCount() const {
+      return m_completedVariants.load(std::memory_order_acquire);
+    }
+
     const D3D9FFShader& GetVSUbershaderModule() const {
       return m_vsUbershader;
     }
@@ -182,15 +259,21 @@ namespace dxvk {
     }
 
     UINT GetVSCount() const {
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
       return m_vsModules.size();
     }
 
     UINT GetFSCount() const {
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
       return m_fsModules.size();
     }
 
   private:
 
+    D3D9DeviceEx* m_device;
+
+    mutable dxvk::mutex m_mutex;
+
     std::unordered_map<
       D3D9FFShaderKeyVS,
       D3D9FFShader,
@@ -204,6 +287,34 @@ namespace dxvk {
     D3D9FFShader m_vsUbershader;
     D3D9FFShader m_fsUbershader;
 
+    dxvk::mutex               m_workerMutex;
+    dxvk::condition_variable  m_workerCond;
+    dxvk::thread              m_worker;
+    bool                      m_workerStopped = false;
+
+    std::queue<D3D9FFShaderKeyVS> m_vsQueue;
+    std::queue<D3D9FFShaderKeyFS> m_fsQueue;
+
+    std::unordered_set<
+      D3D9FFShaderKeyVS,
+      D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_vsPending;
+
+    std::unordered_set<
+      D3D9FFShaderKeyFS,
+      D3D9FFShaderKeyHash, D3D9FFShaderKeyEq> m_fsPending;
+
+    std::atomic<uint32_t>     m_completedVariants = { 0u };
+
+    template <typename T>
+    void EnqueueVariant(
+      const T&                    ShaderKey);
+
+    template <typename T>
+    void PrecompileVariants(
+      const std::string&          Prefix);
+
+    void RunWorker();
+
   };
 
 
@@ -5,7 +5,8 @@ namespace dxvk::hud {
   HudTextureMemory::HudTextureMemory(D3D9DeviceEx* device)
   : m_device          (device)
   , m_allocatedString ("")
-  , m_mappedString    ("") { }
+  , m_mappedString    ("")
+  , m_compressedString("") { }
 
 
   void HudTextureMemory::update(dxvk::high_resolution_clock::time_point time) {
@@ -14,6 +15,7 @@ namespace dxvk::hud {
     m_maxAllocated = std::max(m_maxAllocated, allocator->AllocatedMemory());
     m_maxUsed = std::max(m_maxUsed, allocator->UsedMemory());
     m_maxMapped = std::max(m_maxMapped, allocator->MappedMemory());
+    m_maxCompressed = std::max(m_maxCompressed, allocator->CompressedMemory());
 
     auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
 
@@ -22,9 +24,11 @@ namespace dxvk::hud {
 
     m_allocatedString = str::format(m_maxAllocated >> 20, " MB (Used: ", m_maxUsed >> 20, " MB)");
     m_mappedString = str::format(m_maxMapped >> 20, " MB");
+    m_compressedString = str::format(m_maxCompressed >> 20, " MB");
     m_maxAllocated = 0;
     m_maxUsed = 0;
     m_maxMapped = 0;
+    m_maxCompressed = 0;
     m_lastUpdate = time;
   }
 
@@ -43,10 +47,68 @@ namespace dxvk::hud {
     renderer.drawText(16, position, 0xffc0ff00u, "Mapped:");
     renderer.drawText(16, { position.x + 120, position.y }, 0xffffffffu, m_mappedString);
 
+#ifndef D3D9_ALLOW_UNMAPPING
+    // Texture memory compression is only supported on 64-bit
+    if (m_device->GetOptions()->compressTextureMemory) {
+      position.y += 20;
+      renderer.drawText(16, position, 0xffc0ff00u, "Compressed:");
+      renderer.drawText(16, { position.x + 120, position.y }, 0xffffffffu, m_compressedString);
+    }
+#endif
+
+    position.y += 8;
+    return position;
+  }
+
+  HudManagedUploads::HudManagedUploads(D3D9DeviceEx* device)
+  : m_device        (device)
+  , m_prevStats     (device->GetUploadStats())
+  , m_bytesString   ("")
+  , m_copiesString  ("") { }
+
+
+  void HudManagedUploads::update(dxvk::high_resolution_clock::time_point time) {
+    m_frameCount += 1u;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
+
+    if (elapsed.count() < UpdateInterval)
+      return;
+
+    D3D9UploadStats stats = m_device->GetUploadStats();
+
+    uint64_t bytesPerFrame   = (stats.bytes   - m_prevStats.bytes)   / m_frameCount;
+    uint64_t copiesPerFrame  = (stats.copies  - m_prevStats.copies)  / m_frameCount;
+    uint64_t batchesPerFrame = (stats.batches - m_prevStats.batches) / m_frameCount;
+
+    m_bytesString = str::format(bytesPerFrame >> 10, " kB");
+    m_copiesString = str::format(copiesPerFrame, " (", batchesPerFrame, " batches)");
+
+    m_prevStats = stats;
+    m_frameCount = 0u;
+    m_lastUpdate = time;
+  }
+
+
+  HudPos HudManagedUploads::render(
+    const Rc<DxvkCommandList>&ctx,
+    const HudPipelineKey&     key,
+    const HudOptions&         options,
+          HudRenderer&        renderer,
+          HudPos              position) {
+    position.y += 16;
+    renderer.drawText(16, position, 0xffc0ff00u, "Uploads:");
+    renderer.drawText(16, { position.x + 120, position.y }, 0xffffffffu, m_bytesString);
+
+    position.y += 20;
+    renderer.drawText(16, position, 0xffc0ff00u, "Copies:");
+    renderer.drawText(16, { position.x + 120, position.y }, 0xffffffffu, m_copiesString);
+
     position.y += 8;
     return position;
   }
 
+
   HudFixedFunctionShaders::HudFixedFunctionShaders(D3D9DeviceEx* device)
   : m_device        (device)
   , m_ffShaderCount ("") {}
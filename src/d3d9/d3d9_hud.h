@@ -27,15 +27,51 @@ namespace dxvk::hud {
 
     D3D9DeviceEx* m_device;
 
-    uint32_t m_maxAllocated = 0;
-    uint32_t m_maxUsed      = 0;
-    uint32_t m_maxMapped    = 0;
+    size_t m_maxAllocated  = 0;
+    size_t m_maxUsed       = 0;
+    size_t m_maxMapped     = 0;
+    size_t m_maxCompressed = 0;
 
     dxvk::high_resolution_clock::time_point m_lastUpdate
       = dxvk::high_resolution_clock::now();
 
     std::string m_allocatedString;
     std::string m_mappedString;
+    std::string m_compressedString;
+
+  };
+
+
+  /**
+   * \brief HUD item to display managed texture uploads
+   */
+  class HudManagedUploads : public HudItem {
+    constexpr static int64_t UpdateInterval = 500'000;
+  public:
+
+    HudManagedUploads(D3D9DeviceEx* device);
+
+    void update(dxvk::high_resolution_clock::time_point time);
+
+    HudPos render(
+      const Rc<DxvkCommandList>&ctx,
+      const HudPipelineKey&     key,
+      const HudOptions&         options,
+            HudRenderer&        renderer,
+            HudPos              position);
+
+  private:
+
+    D3D9DeviceEx* m_device;
+
+    D3D9UploadStats m_prevStats;
+    uint32_t        m_frameCount = 0u;
+
+    dxvk::high_resolution_clock::time_point m_lastUpdate
+      = dxvk::high_resolution_clock::now();
+
+    std::string m_bytesString;
+    std::string m_copiesString;
 
   };
 
@@ -3,6 +3,9 @@
 #include "../util/util_math.h"
 #include "../util/log/log.h"
 #include "../util/util_likely.h"
+#include "../util/util_env.h"
+#include "../util/util_error.h"
+#include "../util/util_lz.h"
 #include <utility>
 #include <algorithm>
 
@@ -83,15 +86,15 @@ namespace dxvk {
     m_mappedMemory -= chunk->UnmapLocked(Memory);
   }
 
-  uint32_t D3D9MemoryAllocator::MappedMemory() const {
+  size_t D3D9MemoryAllocator::MappedMemory() const {
     return m_mappedMemory.load();
   }
 
-  uint32_t D3D9MemoryAllocator::UsedMemory() const {
+  size_t D3D9MemoryAllocator::UsedMemory() const {
     return m_usedMemory.load();
   }
 
-  uint32_t D3D9MemoryAllocator::AllocatedMemory() const {
+  size_t D3D9MemoryAllocator::AllocatedMemory() const {
     return m_allocatedMemory.load();
   }
 
@@ -306,24 +309,132 @@ namespace dxvk {
 
 #else
 
+  D3D9MemoryAllocator::D3D9MemoryAllocator() {
+
+  }
+
+  D3D9MemoryAllocator::~D3D9MemoryAllocator() {
+    { std::unique_lock lock(m_workerMutex);
+      m_workerStopped = true;
+      m_workerCond.notify_one();
+    }
+
+    if (m_worker.joinable())
+      m_worker.join();
+  }
+
   D3D9Memory D3D9MemoryAllocator::Alloc(uint32_t Size) {
     D3D9Memory memory(this, Size);
+
+    if (unlikely(!memory))
+      return memory;
+
     m_allocatedMemory += Size;
+    m_residentMemory += Size;
     return memory;
   }
 
-  uint32_t D3D9MemoryAllocator::MappedMemory() const {
-    return m_allocatedMemory.load();
+  size_t D3D9MemoryAllocator::MappedMemory() const {
+    // Memory queued for compression is expected to be
+    // released soon, so don't evict anything else for it
+    size_t resident = m_residentMemory.load();
+    size_t pending = m_pendingMemory.load();
+    return resident > pending ? resident - pending : size_t(0u);
   }
 
-  uint32_t D3D9MemoryAllocator::UsedMemory() const {
+  size_t D3D9MemoryAllocator::UsedMemory() const {
     return m_allocatedMemory.load();
   }
 
-  uint32_t D3D9MemoryAllocator::AllocatedMemory() const {
+  size_t D3D9MemoryAllocator::AllocatedMemory() const {
     return m_allocatedMemory.load();
   }
 
+  size_t D3D9MemoryAllocator::CompressedMemory() const {
+    return m_compressedMemory.load();
+  }
+
+  void D3D9MemoryAllocator::QueueEviction(const Rc<D3D9MemoryBlock>& Block) {
+    D3D9MemoryEviction eviction;
+
+    { std::lock_guard lock(Block->mutex);
+
+      if (Block->ptr == nullptr || Block->incompressible || Block->evictPending)
+        return;
+
+      Block->evictPending = true;
+
+      eviction.block = Block;
+      eviction.useCount = Block->useCount;
+    }
+
+    m_pendingMemory += Block->size;
+
+    std::unique_lock lock(m_workerMutex);
+    m_evictionQueue.push(std::move(eviction));
+
+    if (!m_worker.joinable()) {
+      m_worker = dxvk::thread([this] { RunWorker(); });
+      m_worker.set_priority(ThreadPriority::Lowest);
+    }
+
+    m_workerCond.notify_one();
+  }
+
+  void D3D9MemoryAllocator::CompressBlock(D3D9MemoryBlock& Block, uint64_t UseCount) {
+    std::lock_guard lock(Block.mutex);
+    Block.evictPending = false;
+
+    // Skip memory that was freed or used again after it was queued
+    if (Block.ptr == nullptr || Block.useCount != UseCount)
+      return;
+
+    std::vector<uint8_t> compressed(lz::compressBound(Block.size));
+    size_t compressedSize = lz::compress(Block.ptr, Block.size, compressed.data(), compressed.size());
+
+    // Don't bother keeping data compressed if it does not save
+    // much memory, decompressing it costs time on every lock.
+    if (!compressedSize || compressedSize > Block.size - Block.size / 4u) {
+      Block.incompressible = true;
+      return;
+    }
+
+    compressed.resize(compressedSize);
+    compressed.shrink_to_fit();
+
+    free(Block.ptr);
+    Block.ptr = nullptr;
+    Block.compressed = std::move(compressed);
+
+    m_residentMemory -= Block.size;
+    m_compressedMemory += Block.compressed.size();
+  }
+
+  void D3D9MemoryAllocator::RunWorker() {
+    env::setThreadName("dxvk-compress");
+
+    while (true) {
+      D3D9MemoryEviction eviction;
+
+      { std::unique_lock lock(m_workerMutex);
+
+        m_workerCond.wait(lock, [this] {
+          return m_workerStopped || !m_evictionQueue.empty();
+        });
+
+        if (m_workerStopped)
+          return;
+
+        eviction = std::move(m_evictionQueue.front());
+        m_evictionQueue.pop();
+      }
+
+      CompressBlock(*eviction.block, eviction.useCount);
+
+      m_pendingMemory -= eviction.block->size;
+    }
+  }
+
   D3D9Memory::D3D9Memory(D3D9MemoryAllocator* pAllocator, size_t Size)
     : m_allocator (pAllocator),
       m_ptr       (malloc(Size)),
@@ -332,7 +443,8 @@ namespace dxvk {
   D3D9Memory::D3D9Memory(D3D9Memory&& other)
     : m_allocator(std::exchange(other.m_allocator, nullptr)),
       m_ptr(std::exchange(other.m_ptr, nullptr)),
-      m_size(std::exchange(other.m_size, 0)) {}
+      m_size(std::exchange(other.m_size, 0)),
+      m_block(std::move(other.m_block)) {}
 
   D3D9Memory::~D3D9Memory() {
     this->Free();
@@ -344,18 +456,82 @@ namespace dxvk {
     m_allocator = std::exchange(other.m_allocator, nullptr);
     m_ptr = std::exchange(other.m_ptr, nullptr);
     m_size = std::exchange(other.m_size, 0);
+    m_block = std::move(other.m_block);
     return *this;
   }
 
   void D3D9Memory::Free() {
+    if (m_block != nullptr) {
+      std::lock_guard lock(m_block->mutex);
+
+      if (m_block->ptr != nullptr) {
+        free(m_block->ptr);
+        m_block->ptr = nullptr;
+        m_allocator->m_residentMemory -= m_size;
+      } else {
+        m_allocator->m_compressedMemory -= m_block->compressed.size();
+        m_block->compressed = std::vector<uint8_t>();
+      }
+
+      m_allocator->m_allocatedMemory -= m_size;
+    } else if (m_ptr != nullptr) {
+      free(m_ptr);
+
+      m_allocator->m_residentMemory -= m_size;
+      m_allocator->m_allocatedMemory -= m_size;
+    }
+
+    m_block = nullptr;
+    m_ptr = nullptr;
+  }
+
+  void D3D9Memory::Evict() {
     if (m_ptr == nullptr)
       return;
 
-    free(m_ptr);
+    // Move the data into a shared block the first time
+    // the memory gets evicted, so the worker can access it.
+    if (m_block == nullptr) {
+      m_block = new D3D9MemoryBlock();
+      m_block->allocator = m_allocator;
+      m_block->size = m_size;
+      m_block->ptr = m_ptr;
+    }
+
+    // The pointer must not be used until the next Map,
+    // which will cancel the eviction if still pending.
     m_ptr = nullptr;
-    m_allocator->NotifyFreed(m_size);
+    m_allocator->QueueEviction(m_block);
   }
 
+  void D3D9Memory::MapBlock() {
+    if (unlikely(m_block == nullptr))
+      return;
+
+    std::lock_guard lock(m_block->mutex);
+    m_block->useCount += 1u;
+
+    if (unlikely(m_block->ptr == nullptr)) {
+      // Texture data would be lost at this point,
+      // so treat any failure here as fatal.
+      void* ptr = malloc(m_block->size);
+
+      if (unlikely(ptr == nullptr))
+        throw DxvkError("D3D9Memory: Failed to allocate memory for decompression");
+
+      if (unlikely(!lz::decompress(m_block->compressed.data(), m_block->compressed.size(), ptr, m_block->size))) {
+        free(ptr);
+        throw DxvkError("D3D9Memory: Failed to decompress texture data");
+      }
+
+      m_block->ptr = ptr;
+      m_block->allocator->m_residentMemory += m_block->size;
+      m_block->allocator->m_compressedMemory -= m_block->compressed.size();
+      m_block->compressed = std::vector<uint8_t>();
+    }
+
+    m_ptr = m_block->ptr;
+  }
 
 #endif
 
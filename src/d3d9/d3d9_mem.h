@@ -2,6 +2,7 @@
 #pragma once
 
 #include "../util/thread.h"
+#include "../util/util_likely.h"
 
 #if defined(_WIN32) && !defined(_WIN64)
   #define D3D9_ALLOW_UNMAPPING
@@ -12,6 +13,9 @@
   #include <winbase.h>
 #endif
 
+#include "../util/rc/util_rc_ptr.h"
+
+#include <queue>
 #include <vector>
 
 namespace dxvk {
@@ -86,6 +90,14 @@ namespace dxvk {
       void Unmap();
       void* Ptr();
 
+      /**
+       * \brief Releases resident memory
+       *
+       * Called for memory that has not been used in a while.
+       * The memory will be made resident again by \c Map.
+       */
+      void Evict() { Unmap(); }
+
     private:
       D3D9Memory(D3D9MemoryChunk* Chunk, size_t Offset, size_t Size);
       void Free();
@@ -110,9 +122,10 @@ namespace dxvk {
       void Free(D3D9Memory* Memory);
       void* Map(D3D9Memory* Memory);
       void Unmap(D3D9Memory* Memory);
-      uint32_t MappedMemory() const;
-      uint32_t UsedMemory() const;
-      uint32_t AllocatedMemory() const;
+      size_t MappedMemory() const;
+      size_t UsedMemory() const;
+      size_t AllocatedMemory() const;
+      size_t CompressedMemory() const { return 0u; }
       uint32_t AllocationGranularity() const { return m_allocationGranularity; }
       uint32_t MappingGranularity() const { return m_mappingGranularity; }
 
@@ -129,6 +142,34 @@ namespace dxvk {
   };
 
 #else
+  /**
+   * \brief Memory block
+   *
+   * Backing storage of a memory allocation that has been
+   * evicted at least once. Blocks are reference-counted so
+   * that the compression worker can safely access them while
+   * the owner is destroyed. All members except the allocator
+   * and size are protected by the mutex.
+   */
+  struct D3D9MemoryBlock : public RcObject {
+    dxvk::mutex           mutex;
+    D3D9MemoryAllocator*  allocator      = nullptr;
+    size_t                size           = 0;
+    void*                 ptr            = nullptr;
+    uint64_t              useCount       = 0;
+    bool                  evictPending   = false;
+    bool                  incompressible = false;
+    std::vector<uint8_t>  compressed;
+  };
+
+  /**
+   * \brief Pending eviction
+   */
+  struct D3D9MemoryEviction {
+    Rc<D3D9MemoryBlock>   block;
+    uint64_t              useCount       = 0;
+  };
+
   class D3D9Memory {
     friend D3D9MemoryAllocator;
 
@@ -142,34 +183,71 @@ namespace dxvk {
       D3D9Memory             (D3D9Memory&& other);
       D3D9Memory& operator = (D3D9Memory&& other);
 
-      explicit operator bool() const { return m_ptr != nullptr; }
+      explicit operator bool() const { return m_ptr != nullptr || m_block != nullptr; }
+
+      void Map() {
+        if (unlikely(m_ptr == nullptr))
+          MapBlock();
+      }
 
-      void Map() {}
       void Unmap() {}
       void* Ptr() { return m_ptr; }
 
+      /**
+       * \brief Releases resident memory
+       *
+       * Queues the data for compression on a worker thread,
+       * which frees the uncompressed copy unless the memory
+       * gets mapped again in the meantime. The data will be
+       * decompressed by \c Map. Data that does not compress
+       * well is kept resident.
+       */
+      void Evict();
+
     private:
       D3D9Memory(D3D9MemoryAllocator* pAllocator, size_t Size);
       void Free();
+      void MapBlock();
 
       D3D9MemoryAllocator* m_allocator = nullptr;
       void* m_ptr                      = nullptr;
       size_t m_size                    = 0;
+
+      // Only created once the memory gets evicted, so that
+      // memory that is never compressed stays a plain malloc.
+      Rc<D3D9MemoryBlock> m_block;
     };
 
     class D3D9MemoryAllocator {
+      friend D3D9Memory;
 
     public:
+      D3D9MemoryAllocator();
+      ~D3D9MemoryAllocator();
+
       D3D9Memory Alloc(uint32_t Size);
-      uint32_t MappedMemory() const;
-      uint32_t UsedMemory() const;
-      uint32_t AllocatedMemory() const;
-      void NotifyFreed(uint32_t Size) {
-        m_allocatedMemory -= Size;
-      }
+      size_t MappedMemory() const;
+      size_t UsedMemory() const;
+      size_t AllocatedMemory() const;
+      size_t CompressedMemory() const;
 
     private:
       std::atomic<size_t> m_allocatedMemory = 0;
+      std::atomic<size_t> m_residentMemory = 0;
+      std::atomic<size_t> m_compressedMemory = 0;
+      std::atomic<size_t> m_pendingMemory = 0;
+
+      dxvk::mutex                     m_workerMutex;
+      dxvk::condition_variable        m_workerCond;
+      dxvk::thread                    m_worker;
+      bool                            m_workerStopped = false;
+      std::queue<D3D9MemoryEviction>  m_evictionQueue;
+
+      void QueueEviction(const Rc<D3D9MemoryBlock>& Block);
+
+      void CompressBlock(D3D9MemoryBlock& Block, uint64_t UseCount);
+
+      void RunWorker();
 
     };
 
@@ -57,6 +57,7 @@ namespace dxvk {
     this->memoryTrackTest               = config.getOption<bool>        ("d3d9.memoryTrackTest",               false);
     this->forceSamplerTypeSpecConstants = config.getOption<bool>        ("d3d9.forceSamplerTypeSpecConstants", false);
     this->forceSampleRateShading        = config.getOption<bool>        ("d3d9.forceSampleRateShading",        false);
+    this->optimizeShaders               = config.getOption<bool>        ("d3d9.optimizeShaders",               false);
     this->forceAspectRatio              = config.getOption<std::string> ("d3d9.forceAspectRatio",              "");
     this->forceRefreshRate              = config.getOption<int32_t>     ("d3d9.forceRefreshRate",              0u);
     this->modeCountCompatibility        = config.getOption<bool>        ("d3d9.modeCountCompatibility",        false);
@@ -67,6 +68,7 @@ namespace dxvk {
     this->allowDirectBufferMapping      = config.getOption<bool>        ("d3d9.allowDirectBufferMapping",      true);
     this->seamlessCubes                 = config.getOption<bool>        ("d3d9.seamlessCubes",                 false);
     this->textureMemory                 = config.getOption<int32_t>     ("d3d9.textureMemory",                 100) << 20;
+    this->compressTextureMemory         = config.getOption<bool>        ("d3d9.compressTextureMemory",         false);
     this->deviceLossOnFocusLoss         = config.getOption<bool>        ("d3d9.deviceLossOnFocusLoss",         false);
     this->samplerLodBias                = config.getOption<float>       ("d3d9.samplerLodBias",                0.0f);
     this->clampNegativeLodBias          = config.getOption<bool>        ("d3d9.clampNegativeLodBias",          false);
@@ -75,6 +77,8 @@ namespace dxvk {
     this->extraFrontbuffer              = config.getOption<bool>        ("d3d9.extraFrontbuffer",              false);
     this->ffUbershaderVS                = config.getOption<bool>        ("d3d9.ffUbershaderVS",                true);
     this->ffUbershaderFS                = config.getOption<bool>        ("d3d9.ffUbershaderFS",                true);
+    this->ffPrecompileVariants          = config.getOption<bool>        ("d3d9.ffPrecompileVariants",          false);
+    this->deferShaderCompilation        = config.getOption<bool>        ("d3d9.deferShaderCompilation",        true);
 
     // D3D8 options
     this->drefScaling                   = config.getOption<int32_t>     ("d3d8.scaleDref",                     0);
@@ -101,6 +105,7 @@ namespace dxvk {
     }
 
     this->shaderDumpPath = env::getEnvVar("DXVK_SHADER_DUMP_PATH");
+    this->ffShaderCorpusPath = env::getEnvVar("DXVK_FF_SHADER_CORPUS");
   }
 
 }
@@ -107,6 +107,9 @@ namespace dxvk {
     /// Forces sample rate shading
     bool forceSampleRateShading;
 
+    /// Run SPIR-V optimization passes on translated shaders
+    bool optimizeShaders;
+
     /// Allow D3DLOCK_DISCARD
     bool allowDiscard;
 
@@ -136,9 +139,17 @@ namespace dxvk {
     /// How much virtual memory will be used for textures (in MB).
     int32_t textureMemory;
 
+    /// Compress the system memory copy of managed and system memory
+    /// textures once more than textureMemory is in use, rather than
+    /// keeping all of it resident. Only used on 64-bit builds.
+    bool compressTextureMemory;
+
     /// Shader dump path
     std::string shaderDumpPath;
 
+    /// Fixed-function shader corpus report path
+    std::string ffShaderCorpusPath;
+
     /// Enable emulation of device loss when a fullscreen app loses focus
     bool deviceLossOnFocusLoss;
 
@@ -161,6 +172,15 @@ namespace dxvk {
 
     /// Use the uber shader for fixed function fragment shaders.
     bool ffUbershaderFS;
+
+    /// Compile specialized fixed-function shaders in the background
+    /// while the uber shaders are in use, and precompile variants
+    /// that were used in previous runs.
+    bool ffPrecompileVariants;
+
+    /// Compile shaders on worker threads rather than
+    /// on the thread that creates them
+    bool deferShaderCompilation;
   };
 
 }
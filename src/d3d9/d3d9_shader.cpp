@@ -6,83 +6,386 @@
 
 namespace dxvk {
 
-  D3D9CommonShader::D3D9CommonShader() {}
+  template<typename T>
+  static void AppendShaderData(std::vector<uint8_t>& Data, const T& Value) {
+    static_assert(std::is_trivially_copyable_v<T>);
 
-  D3D9CommonShader::D3D9CommonShader(
+    auto bytes = reinterpret_cast<const uint8_t*>(&Value);
+    Data.insert(Data.end(), bytes, bytes + sizeof(Value));
+  }
+
+
+  template<typename T>
+  static bool ReadShaderData(const std::vector<uint8_t>& Data, size_t& Offset, T& Value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    if (Offset + sizeof(Value) > Data.size())
+      return false;
+
+    std::memcpy(&Value, &Data[Offset], sizeof(Value));
+    Offset += sizeof(Value);
+    return true;
+  }
+
+
+  D3D9SharedShaderModule::Table D3D9SharedShaderModule::s_table;
+
+
+  D3D9SharedShaderModule::D3D9SharedShaderModule(
+    const DxvkShaderCache::SpirvKey&  Key,
+          Rc<DxvkSpirvShader>         Shader,
+          std::vector<uint8_t>        Reflection)
+  : m_key         (Key),
+    m_shader      (std::move(Shader)),
+    m_reflection  (std::move(Reflection)) {
+
+  }
+
+
+  D3D9SharedShaderModule::~D3D9SharedShaderModule() {
+
+  }
+
+
+  Rc<DxvkSpirvShader> D3D9SharedShaderModule::CreateShader() const {
+    return new DxvkSpirvShader(m_shader->getCreateInfo(), m_shader->getRawCode());
+  }
+
+
+  Rc<D3D9SharedShaderModule> D3D9SharedShaderModule::Lookup(
+    const DxvkShaderCache::SpirvKey&  Key) {
+    std::lock_guard lock(s_table.mutex);
+
+    auto entry = s_table.modules.find(Key);
+
+    // Entries whose ref count already dropped to zero are
+    // about to be destroyed and must not be revived
+    if (entry == s_table.modules.end() || !entry->second->TryIncRef())
+      return nullptr;
+
+    Rc<D3D9SharedShaderModule> result = entry->second;
+    entry->second->decRef();
+    return result;
+  }
+
+
+  Rc<D3D9SharedShaderModule> D3D9SharedShaderModule::Insert(
+    const DxvkShaderCache::SpirvKey&  Key,
+          Rc<DxvkSpirvShader>         Shader,
+          std::vector<uint8_t>        Reflection) {
+    std::lock_guard lock(s_table.mutex);
+
+    auto entry = s_table.modules.find(Key);
+
+    if (entry != s_table.modules.end() && entry->second->TryIncRef()) {
+      Rc<D3D9SharedShaderModule> result = entry->second;
+      entry->second->decRef();
+      return result;
+    }
+
+    Rc<D3D9SharedShaderModule> result = new D3D9SharedShaderModule(
+      Key, std::move(Shader), std::move(Reflection));
+
+    s_table.modules.insert_or_assign(Key, result.ptr());
+    return result;
+  }
+
+
+  bool D3D9SharedShaderModule::TryIncRef() {
+    uint32_t refCount = m_refCount.load(std::memory_order_acquire);
+
+    while (refCount) {
+      if (m_refCount.compare_exchange_weak(refCount, refCount + 1u, std::memory_order_acquire))
+        return true;
+    }
+
+    return false;
+  }
+
+
+  void D3D9SharedShaderModule::Free() {
+    { std::lock_guard lock(s_table.mutex);
+
+      // A new entry with the same key may have been added
+      // after the ref count of this entry dropped to zero
+      auto entry = s_table.modules.find(m_key);
+
+      if (entry != s_table.modules.end() && entry->second == this)
+        s_table.modules.erase(entry);
+    }
+
+    delete this;
+  }
+
+
+  D3D9ShaderCompileJob::D3D9ShaderCompileJob(
             D3D9DeviceEx*         pDevice,
             VkShaderStageFlagBits ShaderStage,
       const DxvkShaderHash&       Key,
       const DxsoModuleInfo*       pDxsoModuleInfo,
       const void*                 pShaderBytecode,
-      const DxsoAnalysisInfo&     AnalysisInfo,
-            DxsoModule*           pModule) {
+      const DxsoAnalysisInfo&     AnalysisInfo)
+  : m_device    (pDevice),
+    m_stage     (ShaderStage),
+    m_name      (Key.toString()),
+    m_moduleInfo(*pDxsoModuleInfo),
+    m_analysis  (AnalysisInfo) {
+    // The application may free the bytecode as soon as the shader
+    // has been created, so we need to keep our own copy around.
     const uint32_t bytecodeLength = AnalysisInfo.bytecodeByteLength;
 
-    const std::string name = Key.toString();
-    Logger::debug(str::format("Compiling shader ", name));
+    m_bytecode.resize(align(bytecodeLength, sizeof(uint32_t)) / sizeof(uint32_t));
+    std::memcpy(m_bytecode.data(), pShaderBytecode, bytecodeLength);
+
+    DxsoReader reader(reinterpret_cast<const char*>(m_bytecode.data()));
+    DxsoModule module(reader);
+
+    m_info = module.info();
+  }
+
+
+  D3D9ShaderCompileJob::~D3D9ShaderCompileJob() {
+
+  }
+
+
+  void D3D9ShaderCompileJob::Compile() {
+    State expected = State::Pending;
+
+    if (m_state.compare_exchange_strong(expected, State::Compiling, std::memory_order_acquire)) {
+      // This may run on a worker thread, so no exception
+      // must escape. Failed jobs are reported to the caller.
+      try {
+        RunCompiler();
+      } catch (const DxvkError& e) {
+        Logger::err(str::format("Failed to compile shader ", m_name, ": ", e.message()));
+        m_failed = true;
+      } catch (const std::exception& e) {
+        Logger::err(str::format("Failed to compile shader ", m_name, ": ", e.what()));
+        m_failed = true;
+      } catch (...) {
+        Logger::err(str::format("Failed to compile shader ", m_name));
+        m_failed = true;
+      }
+
+      if (m_failed) {
+        m_shader = nullptr;
+        m_sharedModule = nullptr;
+      }
+
+      // The bytecode is no longer needed once the shader is compiled
+      m_bytecode = std::vector<uint32_t>();
+
+      std::lock_guard lock(m_mutex);
+      m_state.store(State::Ready, std::memory_order_release);
+      m_cond.notify_all();
+    } else if (expected != State::Ready) {
+      std::unique_lock lock(m_mutex);
+
+      m_cond.wait(lock, [this] {
+        return m_state.load(std::memory_order_acquire) == State::Ready;
+      });
+    }
+  }
+
+
+  void D3D9ShaderCompileJob::RunCompiler() {
+    const char* bytecode = reinterpret_cast<const char*>(m_bytecode.data());
+    const uint32_t bytecodeLength = m_analysis.bytecodeByteLength;
+
+    Logger::debug(str::format("Compiling shader ", m_name));
     
     // If requested by the user, dump both the raw DXBC
     // shader and the compiled SPIR-V module to a file.
-    const std::string& dumpPath = pDevice->GetOptions()->shaderDumpPath;
+    const std::string& dumpPath = m_device->GetOptions()->shaderDumpPath;
     
     if (dumpPath.size() != 0) {
-      DxsoReader reader(
-        reinterpret_cast<const char*>(pShaderBytecode));
+      DxsoReader reader(bytecode);
 
-      reader.store(std::ofstream(str::topath(str::format(dumpPath, "/", name, ".dxso").c_str()).c_str(),
+      reader.store(std::ofstream(str::topath(str::format(dumpPath, "/", m_name, ".dxso").c_str()).c_str(),
         std::ios_base::binary | std::ios_base::trunc), bytecodeLength);
 
       char comment[2048];
       Com<ID3DBlob> blob;
       HRESULT hr = DisassembleShader(
-        pShaderBytecode,
+        bytecode,
         TRUE,
         comment, 
         &blob);
       
       if (SUCCEEDED(hr)) {
-        std::ofstream disassembledOut(str::topath(str::format(dumpPath, "/", name, ".dxso.dis").c_str()).c_str(), std::ios_base::binary | std::ios_base::trunc);
+        std::ofstream disassembledOut(str::topath(str::format(dumpPath, "/", m_name, ".dxso.dis").c_str()).c_str(), std::ios_base::binary | std::ios_base::trunc);
         disassembledOut.write(
           reinterpret_cast<const char*>(blob->GetBufferPointer()),
           blob->GetBufferSize());
       }
     }
-    
-    // Decide whether we need to create a pass-through
-    // geometry shader for vertex shader stream output
-
-    const D3D9ConstantLayout& constantLayout = ShaderStage == VK_SHADER_STAGE_VERTEX_BIT
-      ? pDevice->GetVertexConstantLayout()
-      : pDevice->GetPixelConstantLayout();
-    m_shader       = pModule->compile(*pDxsoModuleInfo, name, AnalysisInfo, constantLayout);
-    m_isgn         = pModule->isgn();
-    m_usedSamplers = pModule->usedSamplers();
-    m_textureTypes = pModule->textureTypes();
-
-    // Shift up these sampler bits so we can just
-    // do an or per-draw in the device.
-    // We shift by 17 because 16 ps samplers + 1 dmap (tess)
-    if (ShaderStage == VK_SHADER_STAGE_VERTEX_BIT)
-      m_usedSamplers <<= FirstVSSamplerSlot;
-
-    m_usedRTs              = pModule->usedRTs();
-
-    m_info                 = pModule->info();
-    m_meta                 = pModule->meta();
-    m_constants            = pModule->constants();
-    m_maxDefinedFloatConst = pModule->maxDefinedFloatConstant();
-    m_maxDefinedIntConst   = pModule->maxDefinedIntConstant();
-    m_maxDefinedBoolConst  = pModule->maxDefinedBoolConstant();
+
+    const D3D9ConstantLayout& constantLayout = m_stage == VK_SHADER_STAGE_VERTEX_BIT
+      ? m_device->GetVertexConstantLayout()
+      : m_device->GetPixelConstantLayout();
+
+    // Compiled shaders are keyed by the bytecode hash, which is part
+    // of the name, as well as all options and layouts that affect
+    // code generation. Check if another device in this process has
+    // already compiled the shader before trying the on-disk cache.
+    DxvkShaderCache::SpirvKey cacheKey = GetShaderCacheKey(constantLayout);
+
+    Rc<DxvkSpirvShader> shader;
+    m_sharedModule = D3D9SharedShaderModule::Lookup(cacheKey);
+
+    if (m_sharedModule) {
+      shader = m_sharedModule->CreateShader();
+
+      if (!DeserializeReflection(m_sharedModule->GetReflection())) {
+        Logger::warn(str::format("Invalid reflection data for shared shader ", m_name));
+        m_sharedModule = nullptr;
+        shader = nullptr;
+      }
+    }
+
+    Rc<DxvkShaderCache> shaderCache = m_device->GetDXVKDevice()->getShaderCache();
+
+    if (shaderCache && !shader) {
+      std::vector<uint8_t> reflection;
+      shader = shaderCache->lookupSpirvShader(cacheKey, reflection);
+
+      if (shader && !DeserializeReflection(reflection)) {
+        Logger::warn(str::format("Invalid reflection data for cached shader ", m_name));
+        shader = nullptr;
+      }
+    }
+
+    if (!shader) {
+      DxsoReader reader(bytecode);
+      DxsoModule module(reader);
+
+      shader = module.compile(m_moduleInfo, m_name, m_analysis, constantLayout);
+
+      m_isgn         = module.isgn();
+      m_usedSamplers = module.usedSamplers();
+      m_textureTypes = module.textureTypes();
+
+      // Shift up these sampler bits so we can just
+      // do an or per-draw in the device.
+      // We shift by 17 because 16 ps samplers + 1 dmap (tess)
+      if (m_stage == VK_SHADER_STAGE_VERTEX_BIT)
+        m_usedSamplers <<= FirstVSSamplerSlot;
+
+      m_usedRTs      = module.usedRTs();
+      m_meta         = module.meta();
+      m_constants    = module.constants();
+      m_specConstantMask = module.specConstantMask();
+
+      if (shaderCache)
+        shaderCache->addSpirvShader(cacheKey, shader, SerializeReflection());
+    }
+
+    if (!m_sharedModule)
+      m_sharedModule = D3D9SharedShaderModule::Insert(cacheKey, shader, SerializeReflection());
+
+    m_shader = std::move(shader);
 
     if (dumpPath.size() != 0) {
       std::ofstream dumpStream(
-        str::topath(str::format(dumpPath, "/", name, ".spv").c_str()).c_str(),
+        str::topath(str::format(dumpPath, "/", m_name, ".spv").c_str()).c_str(),
         std::ios_base::binary | std::ios_base::trunc);
       
       m_shader->dump(dumpStream);
     }
 
-    pDevice->GetDXVKDevice()->registerShader(m_shader);
+    m_device->GetDXVKDevice()->registerShader(m_shader);
+  }
+
+
+  DxvkShaderCache::SpirvKey D3D9ShaderCompileJob::GetShaderCacheKey(
+    const D3D9ConstantLayout&   ConstantLayout) const {
+    const DxsoOptions& options = m_moduleInfo.options;
+
+    DxvkShaderCache::SpirvKey key;
+    key.name = m_name;
+    key.add(ReflectionVersion);
+    key.add(options.d3d9FloatEmulation);
+    key.add(options.forceSamplerTypeSpecConstants);
+    key.add(options.forceSampleRateShading);
+    key.add(options.vertexFloatConstantBufferAsSSBO);
+    key.add(options.sincosEmulation);
+    key.add(options.optimizeSpirv);
+    key.add(ConstantLayout.floatCount);
+    key.add(ConstantLayout.intCount);
+    key.add(ConstantLayout.boolCount);
+    key.add(ConstantLayout.bitmaskCount);
+    return key;
+  }
+
+
+  std::vector<uint8_t> D3D9ShaderCompileJob::SerializeReflection() const {
+    std::vector<uint8_t> data;
+    AppendShaderData(data, m_isgn);
+    AppendShaderData(data, m_usedSamplers);
+    AppendShaderData(data, m_usedRTs);
+    AppendShaderData(data, m_textureTypes);
+    AppendShaderData(data, m_meta);
+    AppendShaderData(data, m_specConstantMask);
+    AppendShaderData(data, uint32_t(m_constants.size()));
+
+    for (const auto& constant : m_constants)
+      AppendShaderData(data, constant);
+
+    return data;
+  }
+
+
+  bool D3D9ShaderCompileJob::DeserializeReflection(
+    const std::vector<uint8_t>& Data) {
+    size_t offset = 0u;
+    uint32_t constantCount = 0u;
+
+    bool status = ReadShaderData(Data, offset, m_isgn)
+               && ReadShaderData(Data, offset, m_usedSamplers)
+               && ReadShaderData(Data, offset, m_usedRTs)
+               && ReadShaderData(Data, offset, m_textureTypes)
+               && ReadShaderData(Data, offset, m_meta)
+               && ReadShaderData(Data, offset, m_specConstantMask)
+               && ReadShaderData(Data, offset, constantCount);
+
+    if (!status || Data.size() - offset != constantCount * sizeof(DxsoDefinedConstant))
+      return false;
+
+    m_constants.resize(constantCount);
+
+    for (uint32_t i = 0u; i < constantCount; i++)
+      status = status && ReadShaderData(Data, offset, m_constants[i]);
+
+    return status;
+  }
+
+
+  D3D9CommonShader::D3D9CommonShader() {}
+
+  D3D9CommonShader::D3D9CommonShader(
+    const Rc<D3D9ShaderCompileJob>& Job)
+  : m_job(Job) {
+
+  }
+
+
+  D3D9ShaderModuleSet::D3D9ShaderModuleSet() {
+
+  }
+
+
+  D3D9ShaderModuleSet::~D3D9ShaderModuleSet() {
+    { std::unique_lock lock(m_workerMutex);
+      m_workersStopped = true;
+
+      // Pending jobs will be compiled on first use
+      m_workerQueue = std::queue<Rc<D3D9ShaderCompileJob>>();
+      m_workerCond.notify_all();
+    }
+
+    for (auto& worker : m_workers)
+      worker.join();
   }
 
 
@@ -141,26 +444,9 @@ namespace dxvk {
       hash.digest(),
       hash.digestLength());
 
-    // Use the shader's unique key for the lookup
-    { std::unique_lock<dxvk::mutex> lock(m_mutex);
-      
-      auto entry = m_modules.find(lookupKey);
-      if (entry != m_modules.end()) {
-        *pShaderModule = entry->second;
-        return;
-      }
-    }
-    
-    // This shader has not been compiled yet, so we have to create a
-    // new module. This takes a while, so we won't lock the structure.
-    *pShaderModule = D3D9CommonShader(
-      pDevice, ShaderStage, lookupKey,
-      pDxbcModuleInfo, pShaderBytecode,
-      info, &module);
-
-    const int32_t maxFloatConstantIndex = pShaderModule->GetMaxDefinedFloatConstant();
-    const int32_t maxIntConstantIndex = pShaderModule->GetMaxDefinedIntConstant();
-    const int32_t maxBoolConstantIndex = pShaderModule->GetMaxDefinedBoolConstant();
+    const int32_t maxFloatConstantIndex = info.maxDefinedFloatConstant;
+    const int32_t maxIntConstantIndex = info.maxDefinedIntConstant;
+    const int32_t maxBoolConstantIndex = info.maxDefinedBoolConstant;
 
     // Vertex shader specific validations. These validations are not
     // performed on SWVP devices or on MIXED devices, even if
@@ -201,17 +487,105 @@ namespace dxvk {
         throw DxvkError(str::format("GetShaderModule: Invalid PS bool constant index ", maxBoolConstantIndex));
     }
     
-    // Insert the new module into the lookup table. If another thread
-    // has compiled the same shader in the meantime, we should return
-    // that object instead and discard the newly created module.
+    // Use the shader's unique key for the lookup
     { std::unique_lock<dxvk::mutex> lock(m_mutex);
       
-      auto status = m_modules.insert({ lookupKey, *pShaderModule });
-      if (!status.second) {
-        *pShaderModule = status.first->second;
+      auto entry = m_modules.find(lookupKey);
+      if (entry != m_modules.end()) {
+        *pShaderModule = entry->second;
         return;
       }
     }
+
+    // Creating the job is cheap, the actual compilation happens
+    // either on a worker or when the shader is first used. If
+    // another thread has created the same shader in the meantime,
+    // return that object instead and discard the new one.
+    Rc<D3D9ShaderCompileJob> job = new D3D9ShaderCompileJob(
+      pDevice, ShaderStage, lookupKey,
+      pDxbcModuleInfo, pShaderBytecode, info);
+
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+      
+      auto status = m_modules.insert({ lookupKey, D3D9CommonShader(job) });
+      *pShaderModule = status.first->second;
+
+      if (!status.second)
+        return;
+    }
+
+    if (options->deferShaderCompilation) {
+      EnqueueJob(std::move(job));
+      return;
+    }
+
+    // Without deferred compilation, compile errors fail shader
+    // creation. Remove the failed job so that it is not reused.
+    job->Compile();
+
+    if (unlikely(job->HasFailed())) {
+      { std::unique_lock<dxvk::mutex> lock(m_mutex);
+        m_modules.erase(lookupKey);
+      }
+
+      throw DxvkError(str::format("GetShaderModule: Failed to compile shader ", job->GetName()));
+    }
+  }
+
+
+  void D3D9ShaderModuleSet::EnqueueJob(
+          Rc<D3D9ShaderCompileJob>  Job) {
+    std::unique_lock lock(m_workerMutex);
+
+    if (unlikely(m_workers.empty())) {
+      uint32_t workerCount = dxvk::thread::hardware_concurrency() / 2u;
+
+      if (workerCount <  1) workerCount =  1;
+      if (workerCount > 16) workerCount = 16;
+
+      // Reduce worker count on 32-bit to save address space
+      if (env::is32BitHostPlatform())
+        workerCount = std::min(workerCount, 4u);
+
+      m_workers.reserve(workerCount);
+
+      for (uint32_t i = 0; i < workerCount; i++) {
+        auto& worker = m_workers.emplace_back([this] {
+          RunWorker();
+        });
+
+        worker.set_priority(ThreadPriority::Lowest);
+      }
+
+      Logger::info(str::format("D3D9: Using ", workerCount, " shader compiler threads"));
+    }
+
+    m_workerQueue.push(std::move(Job));
+    m_workerCond.notify_one();
+  }
+
+
+  void D3D9ShaderModuleSet::RunWorker() {
+    env::setThreadName("dxvk-dxso");
+
+    while (true) {
+      Rc<D3D9ShaderCompileJob> job;
+
+      { std::unique_lock lock(m_workerMutex);
+
+        m_workerCond.wait(lock, [this] {
+          return m_workersStopped || !m_workerQueue.empty();
+        });
+
+        if (m_workersStopped)
+          return;
+
+        job = std::move(m_workerQueue.front());
+        m_workerQueue.pop();
+      }
+
+      job->Compile();
+    }
   }
 
 }
@@ -3,6 +3,7 @@
 #include "../dxso/dxso_module.h"
 
 #include "../dxvk/dxvk_shader.h"
+#include "../dxvk/dxvk_shader_cache.h"
 #include "../dxvk/dxvk_shader_key.h"
 
 #include "d3d9_resource.h"
@@ -10,16 +11,241 @@
 #include "d3d9_mem.h"
 
 #include <array>
+#include <queue>
 
 namespace dxvk {
 
 
+  /**
+   * \brief Shared shader module
+   *
+   * Process-wide table entry that stores a compiled DXSO shader
+   * along with its serialized reflection data. Entries are keyed
+   * by the bytecode hash as well as all options and layouts that
+   * affect code generation, so that devices that create the same
+   * shader do not need to compile it again. Entries are removed
+   * from the table once the last reference is released.
+   */
+  class D3D9SharedShaderModule {
+
+  public:
+
+    D3D9SharedShaderModule(
+      const DxvkShaderCache::SpirvKey&  Key,
+            Rc<DxvkSpirvShader>         Shader,
+            std::vector<uint8_t>        Reflection);
+
+    ~D3D9SharedShaderModule();
+
+    void incRef() {
+      m_refCount.fetch_add(1u, std::memory_order_acquire);
+    }
+
+    void decRef() {
+      if (m_refCount.fetch_sub(1u, std::memory_order_release) == 1u)
+        Free();
+    }
+
+    /**
+     * \brief Creates shader object
+     *
+     * Each device gets its own shader object, since pipeline
+     * compilation state is tracked per shader object.
+     * \returns Copy of the compiled shader
+     */
+    Rc<DxvkSpirvShader> CreateShader() const;
+
+    /**
+     * \brief Queries serialized reflection data
+     * \returns Reflection data of the compiled shader
+     */
+    const std::vector<uint8_t>& GetReflection() const {
+      return m_reflection;
+    }
+
+    /**
+     * \brief Looks up shared module
+     *
+     * \param [in] Key Shader name and compile options
+     * \returns Shared module, or \c nullptr if no shader
+     *    with the given key is currently alive.
+     */
+    static Rc<D3D9SharedShaderModule> Lookup(
+      const DxvkShaderCache::SpirvKey&  Key);
+
+    /**
+     * \brief Adds compiled shader to the table
+     *
+     * If another thread has added the same shader in the
+     * meantime, the existing entry will be returned.
+     * \param [in] Key Shader name and compile options
+     * \param [in] Shader Compiled shader
+     * \param [in] Reflection Serialized reflection data
+     * \returns Shared module
+     */
+    static Rc<D3D9SharedShaderModule> Insert(
+      const DxvkShaderCache::SpirvKey&  Key,
+            Rc<DxvkSpirvShader>         Shader,
+            std::vector<uint8_t>        Reflection);
+
+  private:
+
+    struct Table {
+      dxvk::mutex mutex;
+
+      std::unordered_map<
+        DxvkShaderCache::SpirvKey,
+        D3D9SharedShaderModule*,
+        DxvkHash, DxvkEq> modules;
+    };
+
+    static Table s_table;
+
+    std::atomic<uint32_t>     m_refCount = { 0u };
+
+    DxvkShaderCache::SpirvKey m_key;
+    Rc<DxvkSpirvShader>       m_shader;
+    std::vector<uint8_t>      m_reflection;
+
+    bool TryIncRef();
+
+    void Free();
+
+  };
+
+
+  /**
+   * \brief Shader compile job
+   *
+   * Stores everything needed to compile a DXSO shader, as well
+   * as the compiled shader and its reflection data once done.
+   * Compilation may either happen on a worker thread or when
+   * the shader is first used, whichever comes first.
+   */
+  class D3D9ShaderCompileJob : public RcObject {
+
+  public:
+
+    D3D9ShaderCompileJob(
+            D3D9DeviceEx*         pDevice,
+            VkShaderStageFlagBits ShaderStage,
+      const DxvkShaderHash&       Key,
+      const DxsoModuleInfo*       pDxsoModuleInfo,
+      const void*                 pShaderBytecode,
+      const DxsoAnalysisInfo&     AnalysisInfo);
+
+    ~D3D9ShaderCompileJob();
+
+    /**
+     * \brief Compiles the shader
+     *
+     * If another thread is already compiling the shader, this
+     * will wait for that to finish. Does nothing if the shader
+     * has already been compiled.
+     */
+    void Compile();
+
+    /**
+     * \brief Checks whether the shader is ready
+     * \returns \c true if compilation has finished
+     */
+    bool IsCompiled() const {
+      return m_state.load(std::memory_order_acquire) == State::Ready;
+    }
+
+    /**
+     * \brief Checks whether compilation failed
+     *
+     * Only valid once the shader is compiled. Failed
+     * shaders do not have a shader module.
+     * \returns \c true if the shader failed to compile
+     */
+    bool HasFailed() const {
+      return m_failed;
+    }
+
+    const std::string& GetName() const { return m_name; }
+
+    const DxsoProgramInfo& GetInfo() const { return m_info; }
+
+    const DxsoAnalysisInfo& GetAnalysis() const { return m_analysis; }
+
+    Rc<DxvkShader> GetShader() const { return m_shader; }
+
+    const DxsoIsgn& GetIsgn() const { return m_isgn; }
+
+    const DxsoShaderMetaInfo& GetMeta() const { return m_meta; }
+
+    const DxsoDefinedConstants& GetConstants() const { return m_constants; }
+
+    uint32_t GetUsedSamplers() const { return m_usedSamplers; }
+
+    uint32_t GetUsedRTs() const { return m_usedRTs; }
+
+    uint32_t GetTextureTypes() const { return m_textureTypes; }
+
+    const D3D9SpecConstantMask& GetSpecConstantMask() const { return m_specConstantMask; }
+
+  private:
+
+    // Bumped whenever the serialized reflection data changes,
+    // so that stale cache entries are never deserialized.
+    static constexpr uint32_t ReflectionVersion = 1u;
+
+    enum class State : uint32_t {
+      Pending   = 0u,
+      Compiling = 1u,
+      Ready     = 2u,
+    };
+
+    D3D9DeviceEx*         m_device;
+    VkShaderStageFlagBits m_stage;
+    std::string           m_name;
+    DxsoModuleInfo        m_moduleInfo;
+    DxsoProgramInfo       m_info;
+    DxsoAnalysisInfo      m_analysis;
+    std::vector<uint32_t> m_bytecode;
+
+    std::atomic<State>        m_state = { State::Pending };
+    bool                      m_failed = false;
+    dxvk::mutex               m_mutex;
+    dxvk::condition_variable  m_cond;
+
+    DxsoIsgn              m_isgn;
+    uint32_t              m_usedSamplers = 0u;
+    uint32_t              m_usedRTs      = 0u;
+    uint32_t              m_textureTypes = 0u;
+
+    DxsoShaderMetaInfo    m_meta;
+    DxsoDefinedConstants  m_constants;
+
+    D3D9SpecConstantMask  m_specConstantMask = { };
+
+    Rc<DxvkShader>        m_shader;
+
+    Rc<D3D9SharedShaderModule> m_sharedModule;
+
+    void RunCompiler();
+
+    DxvkShaderCache::SpirvKey GetShaderCacheKey(
+      const D3D9ConstantLayout&   ConstantLayout) const;
+
+    std::vector<uint8_t> SerializeReflection() const;
+
+    bool DeserializeReflection(
+      const std::vector<uint8_t>& Data);
+
+  };
+
+
   /**
    * \brief Common shader object
    * 
    * Stores the compiled SPIR-V shader and the SHA-1
    * hash of the original DXBC shader, which can be
-   * used to identify the shader.
+   * used to identify the shader. Properties that
+   * require the compiled shader will wait for the
+   * compile job to finish.
    */
   class D3D9CommonShader {
 
@@ -28,61 +254,57 @@ namespace dxvk {
     D3D9CommonShader();
 
     D3D9CommonShader(
-            D3D9DeviceEx*         pDevice,
-            VkShaderStageFlagBits ShaderStage,
-      const DxvkShaderHash&       Key,
-      const DxsoModuleInfo*       pDxbcModuleInfo,
-      const void*                 pShaderBytecode,
-      const DxsoAnalysisInfo&     AnalysisInfo,
-            DxsoModule*           pModule);
-
+      const Rc<D3D9ShaderCompileJob>& Job);
 
     Rc<DxvkShader> GetShader() const {
-      return m_shader;
+      return GetCompiledShader().GetShader();
+    }
+
+    bool HasFailed() const {
+      return GetCompiledShader().HasFailed();
     }
 
     std::string GetName() const {
-      return m_shader->debugName();
+      return m_job->GetName();
     }
 
     const DxsoIsgn& GetIsgn() const {
-      return m_isgn;
+      return GetCompiledShader().GetIsgn();
     }
 
-    const DxsoShaderMetaInfo& GetMeta() const { return m_meta; }
-    const DxsoDefinedConstants& GetConstants() const { return m_constants; }
+    const DxsoShaderMetaInfo& GetMeta() const { return GetCompiledShader().GetMeta(); }
+    const DxsoDefinedConstants& GetConstants() const { return GetCompiledShader().GetConstants(); }
+    const D3D9SpecConstantMask& GetSpecConstantMask() const { return GetCompiledShader().GetSpecConstantMask(); }
 
-    D3D9ShaderMasks GetShaderMask() const { return D3D9ShaderMasks{ m_usedSamplers, m_usedRTs }; }
+    D3D9ShaderMasks GetShaderMask() const {
+      const auto& shader = GetCompiledShader();
+      return D3D9ShaderMasks{ shader.GetUsedSamplers(), shader.GetUsedRTs() };
+    }
 
-    const DxsoProgramInfo& GetInfo() const { return m_info; }
+    const DxsoProgramInfo& GetInfo() const { return m_job->GetInfo(); }
 
-    int32_t GetMaxDefinedFloatConstant() const { return m_maxDefinedFloatConst; }
+    int32_t GetMaxDefinedFloatConstant() const { return m_job->GetAnalysis().maxDefinedFloatConstant; }
 
-    int32_t GetMaxDefinedIntConstant() const { return m_maxDefinedIntConst; }
+    int32_t GetMaxDefinedIntConstant() const { return m_job->GetAnalysis().maxDefinedIntConstant; }
 
-    int32_t GetMaxDefinedBoolConstant() const { return m_maxDefinedBoolConst; }
+    int32_t GetMaxDefinedBoolConstant() const { return m_job->GetAnalysis().maxDefinedBoolConstant; }
 
     VkImageViewType GetImageViewType(uint32_t samplerSlot) const {
       const uint32_t offset = samplerSlot * 2;
       const uint32_t mask = 0b11;
-      return static_cast<VkImageViewType>((m_textureTypes >> offset) & mask);
+      return static_cast<VkImageViewType>((GetCompiledShader().GetTextureTypes() >> offset) & mask);
     }
 
   private:
 
-    DxsoIsgn              m_isgn;
-    uint32_t              m_usedSamplers;
-    uint32_t              m_usedRTs;
-    uint32_t              m_textureTypes;
+    Rc<D3D9ShaderCompileJob> m_job;
 
-    DxsoProgramInfo       m_info;
-    DxsoShaderMetaInfo    m_meta;
-    DxsoDefinedConstants  m_constants;
-    int32_t               m_maxDefinedFloatConst = -1;
-    int32_t               m_maxDefinedIntConst = -1;
-    int32_t               m_maxDefinedBoolConst = -1;
+    const D3D9ShaderCompileJob& GetCompiledShader() const {
+      if (unlikely(!m_job->IsCompiled()))
+        m_job->Compile();
 
-    Rc<DxvkShader>        m_shader;
+      return *m_job;
+    }
 
   };
 
@@ -198,12 +420,17 @@ namespace dxvk {
    * 
    * Some applications may compile the same shader multiple
    * times, so we should cache the resulting shader modules
-   * and reuse them rather than creating new ones. This
-   * class is thread-safe.
+   * and reuse them rather than creating new ones. Shaders
+   * are compiled on a set of worker threads if deferred
+   * compilation is enabled. This class is thread-safe.
    */
   class D3D9ShaderModuleSet : public RcObject {
     
   public:
+
+    D3D9ShaderModuleSet();
+
+    ~D3D9ShaderModuleSet();
     
     void GetShaderModule(
             D3D9DeviceEx*         pDevice,
@@ -221,6 +448,17 @@ namespace dxvk {
       DxvkShaderHash,
       D3D9CommonShader,
       DxvkHash, DxvkEq> m_modules;
+
+    dxvk::mutex                           m_workerMutex;
+    dxvk::condition_variable              m_workerCond;
+    std::queue<Rc<D3D9ShaderCompileJob>>  m_workerQueue;
+    std::vector<dxvk::thread>             m_workers;
+    bool                                  m_workersStopped = false;
+
+    void EnqueueJob(
+            Rc<D3D9ShaderCompileJob>  Job);
+
+    void RunWorker();
     
   };
 
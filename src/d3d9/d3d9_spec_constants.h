@@ -295,6 +295,15 @@ namespace dxvk {
     std::array<uint32_t, MaxSpecDwords> data = {};
   };
 
+  /**
+   * \brief Spec constant bit mask
+   *
+   * Stores which bits of each specialization dword
+   * a shader reads. Bits that no shader in a pipeline
+   * reads do not need to be part of the pipeline key.
+   */
+  using D3D9SpecConstantMask = std::array<uint32_t, D3D9SpecializationInfo::MaxSpecDwords>;
+
   class D3D9ShaderSpecConstantManager {
   public:
     uint32_t get(SpirvModule &module, uint32_t specUbo, D3D9SpecConstantId id) {
@@ -313,8 +322,12 @@ namespace dxvk {
       uint32_t val = module.opSelect(uintType, optimized, optimizedValue, quickValue);
       bitCount = std::min(bitCount, layout.sizeInBits - bitOffset);
 
-      if (bitCount == 32)
+      if (bitCount == 32) {
+        m_usedBits[layout.dwordOffset] = ~0u;
         return val;
+      }
+
+      m_usedBits[layout.dwordOffset] |= ((1u << bitCount) - 1u) << (bitOffset + layout.bitOffset);
 
       return module.opBitFieldUExtract(
         module.defIntType(32, 0), val,
@@ -322,6 +335,14 @@ namespace dxvk {
         module.consti32(bitCount));
     }
 
+    /**
+     * \brief Queries spec constant bits read by the shader
+     * \returns Mask of used bits for each dword
+     */
+    const D3D9SpecConstantMask& getUsedBits() const {
+      return m_usedBits;
+    }
+
   private:
     uint32_t getSpecConstDword(SpirvModule &module, uint32_t idx) {
       if (!m_specConstantIds[idx]) {
@@ -354,6 +375,8 @@ namespace dxvk {
     }
 
     std::array<uint32_t, MaxNumSpecConstants + 1> m_specConstantIds = {};
+
+    D3D9SpecConstantMask m_usedBits = {};
   };
 
 }
\ No newline at end of file
@@ -1086,9 +1086,13 @@ namespace dxvk {
 
       hud->addItem<hud::HudFixedFunctionShaders>("ffshaders", -1, m_parent);
       hud->addItem<hud::HudSWVPState>("swvp", -1, m_parent);
+      hud->addItem<hud::HudManagedUploads>("uploads", -1, m_parent);
 
 #ifdef D3D9_ALLOW_UNMAPPING
       hud->addItem<hud::HudTextureMemory>("memory", -1, m_parent);
+#else
+      if (m_parent->GetOptions()->compressTextureMemory)
+        hud->addItem<hud::HudTextureMemory>("memory", -1, m_parent);
 #endif
     }
 
@@ -1138,8 +1142,17 @@ namespace dxvk {
 
 
   void D3D9SwapChainEx::SyncFrameLatency() {
-    // Wait for the sync event so that we respect the maximum frame latency
+    // Wait for the sync event so that we respect the maximum frame latency.
+    // Track the time spent here since this is where vsync and the frame
+    // rate limiter block the application.
+    auto t0 = dxvk::high_resolution_clock::now();
+
     m_wctx->frameLatencySignal->wait(m_wctx->frameId - GetActualFrameLatency());
+
+    auto t1 = dxvk::high_resolution_clock::now();
+    auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+    m_device->addStatCtr(DxvkStatCounter::PresentSyncTicks, ticks.count());
   }
 
   uint32_t D3D9SwapChainEx::GetActualFrameLatency() {
@@ -3,6 +3,7 @@
 #include "d3d9_device.h"
 #include "d3d9_vertex_declaration.h"
 
+#include "../dxvk/dxvk_shader_cache.h"
 #include "../dxvk/dxvk_shader_spirv.h"
 
 #include "../spirv/spirv_module.h"
@@ -300,7 +301,7 @@ namespace dxvk {
       }
     }
 
-    Rc<DxvkShader> finalize() {
+    Rc<DxvkSpirvShader> finalize() {
       m_module.opReturn();
       m_module.functionEnd();
 
@@ -341,11 +342,34 @@ namespace dxvk {
     DxvkShaderHash key(VK_SHADER_STAGE_GEOMETRY_BIT, 0u, hash.digest(), hash.digestLength());
     std::string name = str::format("SWVP_", key.toString());
     
+    // Look up the shader in the on-disk cache before compiling it
+    Rc<DxvkShaderCache> shaderCache = pDevice->GetDXVKDevice()->getShaderCache();
+    DxvkShaderCache::SpirvKey cacheKey;
+    Rc<DxvkShader> shader;
+
+    if (shaderCache) {
+      cacheKey.name = name;
+
+      for (const auto& element : elements)
+        cacheKey.add(element);
+
+      std::vector<uint8_t> apiData;
+      shader = shaderCache->lookupSpirvShader(cacheKey, apiData);
+    }
+
     // This shader has not been compiled yet, so we have to create a
     // new module. This takes a while, so we won't lock the structure.
-    D3D9SWVPEmulatorGenerator generator(name);
-    generator.compile(elements);
-    Rc<DxvkShader> shader = generator.finalize();
+    if (!shader) {
+      D3D9SWVPEmulatorGenerator generator(name);
+      generator.compile(elements);
+
+      Rc<DxvkSpirvShader> spirvShader = generator.finalize();
+
+      if (shaderCache)
+        shaderCache->addSpirvShader(cacheKey, spirvShader, std::vector<uint8_t>());
+
+      shader = std::move(spirvShader);
+    }
 
     pDevice->GetDXVKDevice()->registerShader(shader);
 
@@ -21,6 +21,17 @@ namespace dxvk {
     if (opcode == DxsoOpcode::TexKill)
       m_analysis->usesKill = true;
 
+    // Track defined constants so that the client API can
+    // validate them without having to compile the shader.
+    int32_t constantIndex = int32_t(ctx.dst.id.num);
+
+    if (opcode == DxsoOpcode::Def)
+      m_analysis->maxDefinedFloatConstant = std::max(m_analysis->maxDefinedFloatConstant, constantIndex);
+    else if (opcode == DxsoOpcode::DefI)
+      m_analysis->maxDefinedIntConstant = std::max(m_analysis->maxDefinedIntConstant, constantIndex);
+    else if (opcode == DxsoOpcode::DefB)
+      m_analysis->maxDefinedBoolConstant = std::max(m_analysis->maxDefinedBoolConstant, constantIndex);
+
     if (opcode == DxsoOpcode::DsX
      || opcode == DxsoOpcode::DsY
 
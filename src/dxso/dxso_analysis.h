@@ -11,6 +11,10 @@ namespace dxvk {
     bool usesDerivatives = false;
     bool usesKill        = false;
 
+    int32_t maxDefinedFloatConstant = -1;
+    int32_t maxDefinedIntConstant   = -1;
+    int32_t maxDefinedBoolConstant  = -1;
+
     std::vector<DxsoInstructionContext> coissues;
   };
 
@@ -9,6 +9,7 @@
 #include "../d3d9/d3d9_fixed_function.h"
 
 #include "../dxvk/dxvk_shader_spirv.h"
+#include "../spirv/spirv_optimize.h"
 
 #include <cfloat>
 
@@ -223,7 +224,7 @@ namespace dxvk {
   }
 
 
-  Rc<DxvkShader> DxsoCompiler::compile() {
+  Rc<DxvkSpirvShader> DxsoCompiler::compile() {
     DxvkSpirvShaderCreateInfo info;
     info.bindingCount = m_bindings.size();
     info.bindings = m_bindings.data();
@@ -234,7 +235,12 @@ namespace dxvk {
     if (m_programInfo.type() == DxsoProgramTypes::PixelShader)
       info.flatShadingInputs = m_ps.flatShadingMask;
 
-    return new DxvkSpirvShader(info, m_module.compile());
+    SpirvCodeBuffer code = m_module.compile();
+
+    if (m_moduleInfo.options.optimizeSpirv)
+      code = spirvOptimize(code);
+
+    return new DxvkSpirvShader(info, std::move(code));
   }
 
   void DxsoCompiler::emitInit() {
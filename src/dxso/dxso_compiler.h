@@ -8,6 +8,8 @@
 
 #include "../d3d9/d3d9_constant_layout.h"
 #include "../d3d9/d3d9_spec_constants.h"
+#include "../dxvk/dxvk_shader_spirv.h"
+
 #include "../spirv/spirv_module.h"
 
 namespace dxvk {
@@ -239,7 +241,7 @@ namespace dxvk {
      * \brief Compiles the shader
      * \returns The final shader objects
      */
-    Rc<DxvkShader> compile();
+    Rc<DxvkSpirvShader> compile();
 
     const DxsoIsgn& isgn() { return m_isgn; }
     const DxsoIsgn& osgn() { return m_osgn; }
@@ -252,6 +254,7 @@ namespace dxvk {
     int32_t  maxDefinedIntConstant() const { return m_maxDefinedIntConstant; }
     int32_t  maxDefinedBoolConstant() const { return m_maxDefinedBoolConstant; }
     uint32_t textureTypes() const { return m_textureTypes; }
+    const D3D9SpecConstantMask& specConstantMask() const { return m_spec.getUsedBits(); }
 
   private:
 
@@ -3,6 +3,8 @@
 #include "dxso_code.h"
 #include "dxso_compiler.h"
 
+#include "../dxvk/dxvk_compile_trace.h"
+
 #include <memory>
 
 namespace dxvk {
@@ -21,11 +23,13 @@ namespace dxvk {
     return info;
   }
 
-  Rc<DxvkShader> DxsoModule::compile(
+  Rc<DxvkSpirvShader> DxsoModule::compile(
     const DxsoModuleInfo&     moduleInfo,
     const std::string&        fileName,
     const DxsoAnalysisInfo&   analysis,
     const D3D9ConstantLayout& layout) {
+    DxvkCompileTraceScope trace(DxvkCompileTraceCategory::DxsoCompile, fileName);
+
     auto compiler = std::make_unique<DxsoCompiler>(
       fileName, moduleInfo,
       m_header.info(), analysis,
@@ -49,7 +53,9 @@ namespace dxvk {
     // after that.
     m_usedRTs = compiler->usedRTs();
 
-    return compiler->compile();
+    Rc<DxvkSpirvShader> shader = compiler->compile();
+    m_specConstantMask = compiler->specConstantMask();
+    return shader;
   }
 
   void DxsoModule::runAnalyzer(
@@ -9,6 +9,7 @@
 #include "dxso_analysis.h"
 
 #include "../d3d9/d3d9_constant_layout.h"
+#include "../d3d9/d3d9_spec_constants.h"
 
 #include <vector>
 
@@ -16,6 +17,7 @@ namespace dxvk {
 
   class DxsoCompiler;
   class DxsoCode;
+  class DxvkSpirvShader;
   struct DxsoModuleInfo;
 
   /**
@@ -41,7 +43,7 @@ namespace dxvk {
      *        the compiled SPIR-V for debugging purposes.
      * \returns The compiled shader object
      */
-    Rc<DxvkShader> compile(
+    Rc<DxvkSpirvShader> compile(
       const DxsoModuleInfo&     moduleInfo,
       const std::string&        fileName,
       const DxsoAnalysisInfo&   analysis,
@@ -67,6 +69,8 @@ namespace dxvk {
 
     uint32_t textureTypes() { return m_textureTypes; }
 
+    const D3D9SpecConstantMask& specConstantMask() { return m_specConstantMask; }
+
   private:
 
     void runCompiler(
@@ -85,6 +89,8 @@ namespace dxvk {
     uint32_t        m_usedRTs      = 0u;
     uint32_t        m_textureTypes = 0u;
 
+    D3D9SpecConstantMask m_specConstantMask = { };
+
     DxsoShaderMetaInfo   m_meta;
     int32_t              m_maxDefinedFloatConst = -1;
     int32_t              m_maxDefinedIntConst = -1;
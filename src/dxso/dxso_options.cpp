@@ -17,6 +17,7 @@ namespace dxvk {
 
     forceSamplerTypeSpecConstants = options.forceSamplerTypeSpecConstants;
     forceSampleRateShading = options.forceSampleRateShading;
+    optimizeSpirv = options.optimizeShaders;
 
     vertexFloatConstantBufferAsSSBO = pDevice->GetVertexConstantLayout().floatSize() > devInfo.core.properties.limits.maxUniformBufferRange;
 
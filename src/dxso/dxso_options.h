@@ -29,6 +29,10 @@ namespace dxvk {
 
     /// Whether or not we need to use custom sincos
     bool sincosEmulation = false;
+
+    /// Forward register loads and remove dead stores
+    /// before passing the SPIR-V code to the driver
+    bool optimizeSpirv = false;
   };
 
 }
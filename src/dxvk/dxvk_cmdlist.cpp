@@ -415,6 +415,14 @@ namespace dxvk {
     // Increment queue submission count
     uint64_t submissionCount = m_cmdSubmissions.size();
     m_statCounters.addCtr(DxvkStatCounter::QueueSubmitCount, submissionCount);
+
+    // Count sparse binding operations, both as recorded
+    // and after coalescing binds to the same pages
+    for (const auto& sparseBind : m_cmdSparseBinds) {
+      m_statCounters.addCtr(DxvkStatCounter::SparseBindCount, 1);
+      m_statCounters.addCtr(DxvkStatCounter::SparseBindPages, sparseBind.getBindRequestCount());
+      m_statCounters.addCtr(DxvkStatCounter::SparseBindPagesUnique, sparseBind.getBindCount());
+    }
   }
 
 
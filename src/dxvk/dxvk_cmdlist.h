@@ -306,6 +306,31 @@ namespace dxvk {
      * to split the command list into multiple submissions.
      */
     void next();
+
+    /**
+     * \brief Checks whether sparse binds can be appended
+     *
+     * Sparse binding operations execute before any command
+     * buffer of the same submission. If the current submission
+     * already contains a sparse bind and no commands have been
+     * recorded since, further binds can be added to it without
+     * splitting the command list, which saves a queue-level
+     * sparse bind submission as well as a full serialization.
+     * Only checks recorded commands, the context must also
+     * ensure that it has no deferred work to flush.
+     * \returns \c true if the pending sparse bind can be used
+     */
+    bool canAppendSparseBinds() const {
+      if (!m_cmd.sparseBind || m_cmd.execCommands)
+        return false;
+
+      for (uint32_t i = 0; i < m_cmd.cmdBuffers.size(); i++) {
+        if (DxvkCmdBuffer(i) != DxvkCmdBuffer::ExecBuffer && m_cmd.cmdBuffers[i])
+          return false;
+      }
+
+      return true;
+    }
     
     /**
      * \brief Tracks an object
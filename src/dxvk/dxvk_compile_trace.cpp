@@ -0,0 +1,126 @@
+#include <array>
+#include <atomic>
+#include <fstream>
+
+#include "dxvk_compile_trace.h"
+
+#include "../util/log/log.h"
+
+#include "../util/util_env.h"
+#include "../util/util_string.h"
+
+namespace dxvk {
+
+  DxvkCompileTrace::Trace*    DxvkCompileTrace::s_trace = new Trace();
+  std::atomic<bool>           DxvkCompileTrace::s_enabled = { !s_trace->path.empty() };
+  DxvkCompileTrace::Finalizer DxvkCompileTrace::s_finalizer;
+
+
+  DxvkCompileTrace::Trace::Trace()
+  : path      (env::getEnvVar("DXVK_COMPILE_TRACE")),
+    startTime (high_resolution_clock::now()) {
+
+  }
+
+
+  DxvkCompileTrace::Finalizer::~Finalizer() {
+    if (!isEnabled())
+      return;
+
+    std::lock_guard lock(s_trace->mutex);
+    s_enabled.store(false, std::memory_order_relaxed);
+
+    if (s_trace->dirty)
+      writeTraceLocked();
+  }
+
+
+  void DxvkCompileTrace::record(
+          DxvkCompileTraceCategory          category,
+          std::string                       name,
+          high_resolution_clock::time_point start,
+          high_resolution_clock::time_point end) {
+    uint32_t threadIndex = getThreadIndex();
+
+    std::lock_guard lock(s_trace->mutex);
+
+    // Events recorded after the final flush would be lost anyway
+    if (!isEnabled())
+      return;
+
+    auto& e = s_trace->events.emplace_back();
+    e.category = category;
+    e.name = std::move(name);
+    e.threadIndex = threadIndex;
+    e.start = start;
+    e.end = end;
+
+    s_trace->dirty = true;
+  }
+
+
+  void DxvkCompileTrace::flush() {
+    if (!isEnabled())
+      return;
+
+    std::lock_guard lock(s_trace->mutex);
+
+    if (s_trace->dirty)
+      writeTraceLocked();
+  }
+
+
+  uint32_t DxvkCompileTrace::getThreadIndex() {
+    static std::atomic<uint32_t> s_threadCount = { 0u };
+    static thread_local uint32_t t_threadIndex = ++s_threadCount;
+    return t_threadIndex;
+  }
+
+
+  void DxvkCompileTrace::writeTraceLocked() {
+    static const std::array<const char*, 7> s_categories = {{
+      "dxso", "ir-convert", "ir-lower", "spirv-patch",
+      "shader-library", "graphics-pipeline", "compute-pipeline",
+    }};
+
+    std::ofstream file(str::topath(s_trace->path.c_str()).c_str(),
+      std::ios_base::trunc | std::ios_base::binary);
+
+    if (!file) {
+      Logger::warn(str::format("Failed to write compile trace: ", s_trace->path));
+      return;
+    }
+
+    file << "{\"traceEvents\":[";
+
+    for (size_t i = 0; i < s_trace->events.size(); i++) {
+      const auto& e = s_trace->events[i];
+
+      auto ts = std::chrono::duration_cast<std::chrono::microseconds>(e.start - s_trace->startTime);
+      auto dur = std::chrono::duration_cast<std::chrono::microseconds>(e.end - e.start);
+
+      file << (i ? ",\n" : "\n")
+           << "{\"name\":\"";
+
+      // Debug names are generated by us, but may
+      // contain application-provided strings
+      for (char c : e.name) {
+        if (c == '"' || c == '\\')
+          file << '\\' << c;
+        else if (uint8_t(c) >= 0x20u)
+          file << c;
+      }
+
+      file << "\",\"cat\":\"" << s_categories.at(uint32_t(e.category)) << "\""
+           << ",\"ph\":\"X\",\"pid\":1"
+           << ",\"tid\":" << e.threadIndex
+           << ",\"ts\":" << ts.count()
+           << ",\"dur\":" << dur.count() << "}";
+    }
+
+    file << "\n]}\n";
+
+    s_trace->dirty = false;
+  }
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../util/thread.h"
+#include "../util/util_time.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Compile trace event category
+   */
+  enum class DxvkCompileTraceCategory : uint32_t {
+    DxsoCompile       = 0,  ///< DXSO to SPIR-V compilation
+    IrConvert         = 1,  ///< Conversion to internal IR
+    IrLower           = 2,  ///< Lowering IR to SPIR-V
+    SpirvPatch        = 3,  ///< SPIR-V binding and linkage patching
+    ShaderLibrary     = 4,  ///< Shader pipeline library creation
+    GraphicsPipeline  = 5,  ///< Graphics pipeline creation
+    ComputePipeline   = 6,  ///< Compute pipeline creation
+  };
+
+
+  /**
+   * \brief Compile trace event
+   */
+  struct DxvkCompileTraceEvent {
+    DxvkCompileTraceCategory category;
+    std::string name;
+    uint32_t threadIndex;
+    high_resolution_clock::time_point start;
+    high_resolution_clock::time_point end;
+  };
+
+
+  /**
+   * \brief Shader and pipeline compile trace
+   *
+   * Records the time spent compiling individual shaders and
+   * pipelines, so that shaders which cause long loading times
+   * or stutter can be identified. Enabled by setting the
+   * \c DXVK_COMPILE_TRACE environment variable to a file
+   * path, which will receive a trace in the Chrome trace
+   * event format that can be loaded in \c about://tracing
+   * or Perfetto. All methods are thread-safe.
+   */
+  class DxvkCompileTrace {
+
+  public:
+
+    /**
+     * \brief Checks whether tracing is enabled
+     * \returns \c true if events should be recorded
+     */
+    static bool isEnabled() {
+      return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Records an event
+     *
+     * \param [in] category Event category
+     * \param [in] name Shader or pipeline name
+     * \param [in] start Time when the operation started
+     * \param [in] end Time when the operation finished
+     */
+    static void record(
+            DxvkCompileTraceCategory          category,
+            std::string                       name,
+            high_resolution_clock::time_point start,
+            high_resolution_clock::time_point end);
+
+    /**
+     * \brief Writes trace file
+     *
+     * Overwrites the trace file with all events that were
+     * recorded so far. Called when a device is destroyed,
+     * as well as on process exit, after which any further
+     * events are discarded.
+     */
+    static void flush();
+
+  private:
+
+    struct Trace {
+      Trace();
+
+      std::string                         path;
+
+      dxvk::mutex                         mutex;
+      high_resolution_clock::time_point   startTime;
+      std::vector<DxvkCompileTraceEvent>  events;
+      bool                                dirty = false;
+    };
+
+    struct Finalizer {
+      ~Finalizer();
+    };
+
+    // Never freed so that worker threads that are still
+    // running on process exit can safely access it
+    static Trace*             s_trace;
+    static std::atomic<bool>  s_enabled;
+    static Finalizer          s_finalizer;
+
+    static uint32_t getThreadIndex();
+
+    static void writeTraceLocked();
+
+  };
+
+
+  /**
+   * \brief Compile trace scope
+   *
+   * Records an event covering the lifetime of
+   * the scope object if tracing is enabled.
+   */
+  class DxvkCompileTraceScope {
+
+  public:
+
+    DxvkCompileTraceScope(
+            DxvkCompileTraceCategory          category,
+      const std::string&                      name)
+    : m_category(category) {
+      if (DxvkCompileTrace::isEnabled()) {
+        m_enabled = true;
+        m_name = name;
+        m_start = high_resolution_clock::now();
+      }
+    }
+
+    /**
+     * \brief Creates scope with a lazily generated name
+     *
+     * Only invokes the given function if tracing is enabled,
+     * for names that are expensive to generate.
+     * \param [in] category Event category
+     * \param [in] getName Function returning the name
+     */
+    template<typename Fn, std::enable_if_t<std::is_invocable_r_v<std::string, Fn>, bool> = true>
+    DxvkCompileTraceScope(
+            DxvkCompileTraceCategory          category,
+            Fn&&                              getName)
+    : m_category(category) {
+      if (DxvkCompileTrace::isEnabled()) {
+        m_enabled = true;
+        m_name = getName();
+        m_start = high_resolution_clock::now();
+      }
+    }
+
+    ~DxvkCompileTraceScope() {
+      if (m_enabled) {
+        DxvkCompileTrace::record(m_category, std::move(m_name),
+          m_start, high_resolution_clock::now());
+      }
+    }
+
+    DxvkCompileTraceScope             (const DxvkCompileTraceScope&) = delete;
+    DxvkCompileTraceScope& operator = (const DxvkCompileTraceScope&) = delete;
+
+  private:
+
+    DxvkCompileTraceCategory          m_category;
+    bool                              m_enabled = false;
+    std::string                       m_name;
+    high_resolution_clock::time_point m_start;
+
+  };
+
+}
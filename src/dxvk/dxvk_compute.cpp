@@ -4,6 +4,7 @@
 
 #include "../util/util_time.h"
 
+#include "dxvk_compile_trace.h"
 #include "dxvk_compute.h"
 #include "dxvk_device.h"
 #include "dxvk_graphics.h"
@@ -120,8 +121,12 @@ namespace dxvk {
       flags.pNext = std::exchange(info.pNext, &flags);
 
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkResult vr = vk->vkCreateComputePipelines(vk->device(),
-          VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    VkResult vr;
+
+    { DxvkCompileTraceScope trace(DxvkCompileTraceCategory::ComputePipeline, m_debugName);
+      vr = vk->vkCreateComputePipelines(vk->device(),
+        VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    }
 
     if (vr != VK_SUCCESS) {
       Logger::err(str::format("DxvkComputePipeline: Failed to compile pipeline: ", vr));
@@ -2864,9 +2864,12 @@ namespace dxvk {
   void DxvkContext::updatePageTable(
     const DxvkSparseBindInfo&   bindInfo,
           DxvkSparseBindFlags   flags) {
-    // Split command buffers here so that we execute
-    // the sparse binding operation at the right time
-    if (!flags.test(DxvkSparseBindFlag::SkipSynchronization))
+    // Split command buffers here so that we execute the sparse
+    // binding operation at the right time. Back-to-back page table
+    // updates are coalesced into the pending sparse bind, where the
+    // last bind to any given page wins and adjacent pages get merged.
+    if (!flags.test(DxvkSparseBindFlag::SkipSynchronization)
+     && !this->canAppendSparseBinds())
       this->splitCommands();
 
     DxvkSparsePageAllocator* srcAllocator = bindInfo.srcAllocator.ptr();
@@ -8652,6 +8655,28 @@ namespace dxvk {
   }
 
 
+  bool DxvkContext::canAppendSparseBinds() const {
+    // Deferred clears, render passes and pending layout transitions only
+    // get recorded when the command list is split, which would move them
+    // after the sparse bind, so only append if there is no such work.
+    if (!m_deferredClears.empty())
+      return false;
+
+    if (m_flags.any(DxvkContextFlag::GpRenderPassActive,
+                    DxvkContextFlag::CpComputePassActive))
+      return false;
+
+    if (m_sdmaAcquires.hasLayoutTransitions()
+     || m_sdmaBarriers.hasLayoutTransitions()
+     || m_initAcquires.hasLayoutTransitions()
+     || m_initBarriers.hasLayoutTransitions()
+     || m_execBarriers.hasLayoutTransitions())
+      return false;
+
+    return m_cmd->canAppendSparseBinds();
+  }
+
+
   void DxvkContext::discardRenderTarget(
     const DxvkImage&                image,
     const VkImageSubresourceRange&  subresources) {
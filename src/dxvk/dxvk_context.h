@@ -1877,6 +1877,8 @@ namespace dxvk {
 
     void splitCommands();
 
+    bool canAppendSparseBinds() const;
+
     void discardRenderTarget(
       const DxvkImage&                image,
       const VkImageSubresourceRange&  subresources);
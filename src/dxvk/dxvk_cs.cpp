@@ -131,6 +131,27 @@ namespace dxvk {
   }
 
 
+  uint64_t DxvkCsThread::dispatchChunks(
+          size_t            count,
+          DxvkCsChunkRef*   chunks) {
+    uint64_t seq;
+
+    { std::unique_lock<dxvk::mutex> lock(m_mutex);
+      seq = m_queueOrdered.seqDispatch + 1u;
+
+      for (size_t i = 0; i < count; i++) {
+        auto& entry = m_queueOrdered.queue.emplace_back();
+        entry.chunk = std::move(chunks[i]);
+        entry.seq = ++m_queueOrdered.seqDispatch;
+      }
+
+      m_condOnAdd.notify_one();
+    }
+
+    return seq;
+  }
+
+
   void DxvkCsThread::injectChunk(DxvkCsQueue queue, DxvkCsChunkRef&& chunk, bool synchronize) {
     uint64_t timeline = 0u;
 
@@ -531,6 +531,20 @@ namespace dxvk {
      */
     uint64_t dispatchChunk(DxvkCsChunkRef&& chunk);
 
+    /**
+     * \brief Dispatches multiple chunks at once
+     *
+     * Queues all chunks with a single lock operation and wakes
+     * up the worker only once. Chunks are assigned consecutive
+     * sequence numbers in the order they are passed in.
+     * \param [in] count Number of chunks to dispatch
+     * \param [in] chunks Chunks to dispatch
+     * \returns Sequence number of the first chunk
+     */
+    uint64_t dispatchChunks(
+            size_t            count,
+            DxvkCsChunkRef*   chunks);
+
     /**
      * \brief Injects chunk into the command stream
      *
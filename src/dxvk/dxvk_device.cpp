@@ -1,3 +1,4 @@
+#include "dxvk_compile_trace.h"
 #include "dxvk_device.h"
 #include "dxvk_instance.h"
 #include "dxvk_latency_builtin.h"
@@ -40,11 +41,20 @@ namespace dxvk {
     if (env::getEnvVar("DXVK_SHADER_CACHE") != "0" && DxvkShader::getShaderDumpPath().empty())
       m_shaderCache = DxvkShaderCache::getInstance();
 
+    if (m_shaderCache && m_options.prefetchShaderCache) {
+      size_t count = m_shaderCache->prefetchAllShaders();
+
+      if (count)
+        Logger::info(str::format("Prefetching ", count, " cached shaders"));
+    }
+
     logBindingModel();
   }
   
   
   DxvkDevice::~DxvkDevice() {
+    DxvkCompileTrace::flush();
+
     if (m_kmtLocal) {
       D3DKMT_DESTROYDEVICE destroy = { };
       destroy.hDevice = m_kmtLocal;
@@ -512,6 +522,8 @@ namespace dxvk {
     result.setCtr(DxvkStatCounter::PipeCountCompute,  pipe.numComputePipelines);
     result.setCtr(DxvkStatCounter::PipeTasksDone,     workers.tasksCompleted);
     result.setCtr(DxvkStatCounter::PipeTasksTotal,    workers.tasksTotal);
+    result.setCtr(DxvkStatCounter::PipeSpirvCacheHits,   workers.spirvCacheHits);
+    result.setCtr(DxvkStatCounter::PipeSpirvCacheMisses, workers.spirvCacheMisses);
     result.setCtr(DxvkStatCounter::GpuIdleTicks,      m_submissionQueue.gpuIdleTicks());
 
     std::lock_guard<sync::Spinlock> lock(m_statLock);
@@ -540,6 +552,11 @@ namespace dxvk {
   }
 
 
+  Rc<DxvkShaderCache> DxvkDevice::getShaderCache() const {
+    return m_shaderCache;
+  }
+
+
   Rc<DxvkBuffer> DxvkDevice::importBuffer(
     const DxvkBufferCreateInfo& createInfo,
     const DxvkBufferImportInfo& importInfo,
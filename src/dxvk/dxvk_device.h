@@ -501,6 +501,15 @@ namespace dxvk {
       const DxvkIrShaderCreateInfo&         createInfo,
       const Rc<DxvkIrShaderConverter>&      converter);
 
+    /**
+     * \brief Queries shader cache
+     *
+     * Used by client APIs that generate SPIR-V shaders
+     * directly and store them in the cache themselves.
+     * \returns Shader cache, or \c nullptr if disabled
+     */
+    Rc<DxvkShaderCache> getShaderCache() const;
+
     /**
      * \brief Imports a buffer
      *
@@ -696,6 +705,22 @@ namespace dxvk {
       m_statCounters.addCtr(counter, value);
     }
 
+    /**
+     * \brief Queries a single stat counter
+     *
+     * Cheaper than \c getStatCounters, but only supports
+     * counters that are tracked by the device itself.
+     * \param [in] counter Stat counter to query
+     * \returns Current counter value
+     */
+    uint64_t getStatCtr(DxvkStatCounter counter) {
+      if (counter == DxvkStatCounter::GpuIdleTicks)
+        return m_submissionQueue.gpuIdleTicks();
+
+      std::lock_guard<sync::Spinlock> lock(m_statLock);
+      return m_statCounters.getCtr(counter);
+    }
+
     /**
      * \brief Waits for a given submission
      * 
@@ -2,6 +2,7 @@
 
 #include "../util/util_time.h"
 
+#include "dxvk_compile_trace.h"
 #include "dxvk_device.h"
 #include "dxvk_graphics.h"
 #include "dxvk_pipemanager.h"
@@ -1378,7 +1379,11 @@ namespace dxvk {
       flags.pNext = std::exchange(info.pNext, &flags);
 
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkResult vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    VkResult vr;
+
+    { DxvkCompileTraceScope trace(DxvkCompileTraceCategory::GraphicsPipeline, m_debugName);
+      vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    }
 
     if (vr && vr != VK_PIPELINE_COMPILE_REQUIRED_EXT)
       Logger::err(str::format("DxvkGraphicsPipeline: Failed to create base pipeline: ", vr));
@@ -1463,7 +1468,11 @@ namespace dxvk {
       flags.pNext = std::exchange(info.pNext, &flags);
     
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkResult vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    VkResult vr;
+
+    { DxvkCompileTraceScope trace(DxvkCompileTraceCategory::GraphicsPipeline, m_debugName);
+      vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    }
 
     if (vr != VK_SUCCESS) {
       Logger::err(str::format("DxvkGraphicsPipeline: Failed to compile pipeline: ", vr));
@@ -24,6 +24,8 @@ namespace dxvk {
     deviceFilter          = config.getOption<std::string>("dxvk.deviceFilter",        "");
     lowerSinCos           = config.getOption<Tristate>("dxvk.lowerSinCos",            Tristate::Auto);
     tilerMode             = config.getOption<Tristate>("dxvk.tilerMode",              Tristate::Auto);
+    prefetchShaderCache   = config.getOption<bool>    ("dxvk.prefetchShaderCache",    false);
+    adaptiveFlush         = config.getOption<bool>    ("dxvk.adaptiveFlush",          false);
 
     auto budget = config.getOption<int32_t>("dxvk.maxMemoryBudget", 0);
     maxMemoryBudget = VkDeviceSize(std::max(budget, 0)) << 20u;
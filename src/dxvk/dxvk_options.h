@@ -79,6 +79,14 @@ namespace dxvk {
     /// deal with MSAA-related undefined behaviour.
     bool enableImplicitResolves = true;
 
+    /// Loads all cached shaders on a background
+    /// thread when the device is created.
+    bool prefetchShaderCache = false;
+
+    /// Adjusts flush thresholds based on
+    /// measured GPU and CS thread idle times.
+    bool adaptiveFlush = false;
+
     /// Device name
     std::string deviceFilter;
   };
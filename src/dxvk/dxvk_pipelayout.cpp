@@ -411,6 +411,51 @@ namespace dxvk {
   }
 
 
+  bool DxvkShaderBindingMap::eq(const DxvkShaderBindingMap& other) const {
+    if (m_bindings.size() != other.m_bindings.size()
+     || m_pushData.size() != other.m_pushData.size())
+      return false;
+
+    for (const auto& e : m_bindings) {
+      auto dst = other.mapBinding(e.first);
+
+      if (!dst || !dst->eq(e.second))
+        return false;
+    }
+
+    for (size_t i = 0u; i < m_pushData.size(); i++) {
+      if (!m_pushData[i].first.eq(other.m_pushData[i].first)
+       || m_pushData[i].second != other.m_pushData[i].second)
+        return false;
+    }
+
+    return true;
+  }
+
+
+  size_t DxvkShaderBindingMap::hash() const {
+    // Sum up per-binding hashes since map iteration order is undefined
+    size_t bindingHash = 0u;
+
+    for (const auto& e : m_bindings) {
+      DxvkHashState entry;
+      entry.add(e.first.hash());
+      entry.add(e.second.hash());
+      bindingHash += entry;
+    }
+
+    DxvkHashState hash;
+    hash.add(bindingHash);
+
+    for (size_t i = 0u; i < m_pushData.size(); i++) {
+      hash.add(m_pushData[i].first.hash());
+      hash.add(m_pushData[i].second);
+    }
+
+    return hash;
+  }
+
+
   DxvkPipelineBindings::DxvkPipelineBindings(
           DxvkDevice*                 device,
           DxvkPipelineManager*        manager,
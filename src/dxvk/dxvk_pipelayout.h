@@ -1475,6 +1475,38 @@ namespace dxvk {
      */
     uint32_t mapPushData(VkShaderStageFlags stage, uint32_t offset) const;
 
+    /**
+     * \brief Checks for equality
+     *
+     * \param [in] other Binding map to compare to
+     * \returns \c true if both maps produce the same mappings
+     */
+    bool eq(const DxvkShaderBindingMap& other) const;
+
+    /**
+     * \brief Computes hash
+     *
+     * Does not depend on the order in which bindings were added.
+     * \returns Hash value
+     */
+    size_t hash() const;
+
+    /**
+     * \brief Queries binding mappings
+     * \returns Shader bindings and their remapped bindings
+     */
+    const std::unordered_map<DxvkShaderBinding, DxvkShaderBinding, DxvkHash, DxvkEq>& getBindings() const {
+      return m_bindings;
+    }
+
+    /**
+     * \brief Queries push data mappings
+     * \returns Push data blocks and their remapped offsets
+     */
+    const small_vector<std::pair<DxvkPushDataBlock, uint32_t>, DxvkPushDataBlock::MaxBlockCount>& getPushData() const {
+      return m_pushData;
+    }
+
   private:
 
     std::unordered_map<DxvkShaderBinding, DxvkShaderBinding, DxvkHash, DxvkEq> m_bindings;
@@ -7,6 +7,7 @@
 
 #include "dxvk_compute.h"
 #include "dxvk_graphics.h"
+#include "dxvk_shader_spirv.h"
 
 namespace dxvk {
 
@@ -36,6 +37,8 @@ namespace dxvk {
   struct DxvkPipelineWorkerStats {
     uint64_t tasksCompleted;
     uint64_t tasksTotal;
+    uint64_t spirvCacheHits;
+    uint64_t spirvCacheMisses;
   };
 
   /**
@@ -72,6 +75,10 @@ namespace dxvk {
       DxvkPipelineWorkerStats result;
       result.tasksCompleted = m_tasksCompleted.load(std::memory_order_acquire);
       result.tasksTotal = m_tasksTotal.load(std::memory_order_relaxed);
+
+      DxvkSpirvCodeCacheStats spirvCache = DxvkSpirvShader::getCodeCacheStats();
+      result.spirvCacheHits = spirvCache.hits;
+      result.spirvCacheMisses = spirvCache.misses;
       return result;
     }
 
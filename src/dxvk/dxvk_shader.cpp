@@ -1,3 +1,4 @@
+#include "dxvk_compile_trace.h"
 #include "dxvk_device.h"
 #include "dxvk_pipemanager.h"
 #include "dxvk_shader.h"
@@ -151,6 +152,20 @@ namespace dxvk {
   }
 
 
+  std::string DxvkShaderPipelineLibraryKey::getDebugName() const {
+    std::string name;
+
+    for (const auto& shader : m_shaders) {
+      if (!name.empty())
+        name += ", ";
+
+      name += shader->debugName();
+    }
+
+    return name;
+  }
+
+
   bool DxvkShaderPipelineLibraryKey::eq(
     const DxvkShaderPipelineLibraryKey& other) const {
     bool eq = true;
@@ -425,7 +440,11 @@ namespace dxvk {
     info.basePipelineIndex    = -1;
 
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkResult vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    VkResult vr;
+
+    { DxvkCompileTraceScope trace(DxvkCompileTraceCategory::ShaderLibrary, [this] { return m_shaders.getDebugName(); });
+      vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    }
 
     if (vr && vr != VK_PIPELINE_COMPILE_REQUIRED_EXT)
       Logger::err(str::format("DxvkShaderPipelineLibrary: Failed to create vertex shader pipeline: ", vr));
@@ -529,7 +548,11 @@ namespace dxvk {
       info.pMultisampleState  = &msInfo;
 
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkResult vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    VkResult vr;
+
+    { DxvkCompileTraceScope trace(DxvkCompileTraceCategory::ShaderLibrary, [this] { return m_shaders.getDebugName(); });
+      vr = vk->vkCreateGraphicsPipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    }
 
     if (vr && !(flags & VK_PIPELINE_CREATE_2_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT))
       Logger::err(str::format("DxvkShaderPipelineLibrary: Failed to create fragment shader pipeline: ", vr));
@@ -562,7 +585,11 @@ namespace dxvk {
       flagsInfo.pNext = std::exchange(info.pNext, &flagsInfo);
 
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkResult vr = vk->vkCreateComputePipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    VkResult vr;
+
+    { DxvkCompileTraceScope trace(DxvkCompileTraceCategory::ShaderLibrary, [this] { return m_shaders.getDebugName(); });
+      vr = vk->vkCreateComputePipelines(vk->device(), VK_NULL_HANDLE, 1, &info, nullptr, &pipeline);
+    }
 
     if (vr && vr != VK_PIPELINE_COMPILE_REQUIRED_EXT)
       Logger::err(str::format("DxvkShaderPipelineLibrary: Failed to create compute shader pipeline: ", vr));
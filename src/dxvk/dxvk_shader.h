@@ -547,6 +547,12 @@ namespace dxvk {
      */
     void addShader(Rc<DxvkShader> shader);
 
+    /**
+     * \brief Generates debug name
+     * \returns Names of all shaders in the set
+     */
+    std::string getDebugName() const;
+
     /**
      * \brief Checks for equality
      *
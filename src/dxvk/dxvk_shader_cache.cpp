@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iomanip>
 #include <version.h>
 
@@ -16,9 +17,18 @@ namespace dxvk {
 
 
   DxvkShaderCache::~DxvkShaderCache() {
+    if (m_prefetcher.joinable()) {
+      { std::unique_lock lock(m_prefetchMutex);
+        m_prefetchStop = true;
+        m_prefetchCond.notify_one();
+      }
+
+      m_prefetcher.join();
+    }
+
     if (m_writer.joinable()) {
       { std::unique_lock lock(m_writeMutex);
-        m_writeQueue.push(nullptr);
+        m_writeQueue.push(WriteEntry());
         m_writeCond.notify_one();
       }
 
@@ -46,6 +56,16 @@ namespace dxvk {
       return nullptr;
     }
 
+    if (auto shader = takePrefetchedShader(k)) {
+      if (Logger::logLevel() <= LogLevel::Debug)
+        Logger::debug(str::format("Shader cache hit: ", name, " (prefetched)"));
+
+      if (m_loweredLut.find(k) == m_loweredLut.end())
+        shader->setShaderCache(this);
+
+      return shader;
+    }
+
     if (Logger::logLevel() <= LogLevel::Debug) {
       Logger::debug(str::format("Shader cache hit: ", name,
         " (offset: ", entry->second.offset,
@@ -58,13 +78,13 @@ namespace dxvk {
 
     if (!shader) {
       Logger::warn(str::format("Failed to load cached shader ", name));
-
-      if (!openWriteOnlyLocked())
-        Logger::warn(str::format("Failed to re-initialize shader cache ", name));
-
-      m_status.store(Status::OpenWriteOnly, std::memory_order_release);
+      resetLocked(name);
+      return nullptr;
     }
 
+    if (m_loweredLut.find(k) == m_loweredLut.end())
+      shader->setShaderCache(this);
+
     return shader;
   }
 
@@ -78,12 +98,223 @@ namespace dxvk {
     k.createInfo = shader->getShaderCreateInfo();
 
     if (m_lut.find(k) == m_lut.end()) {
-      std::unique_lock lock(m_writeMutex);
-      m_writeQueue.push(std::move(shader));
-      m_writeCond.notify_one();
+      shader->setShaderCache(this);
+
+      WriteEntry entry;
+      entry.irShader = std::move(shader);
+
+      enqueueWrite(std::move(entry));
+    }
+  }
+
+
+  void DxvkShaderCache::addLoweredShader(Rc<DxvkIrShader> shader) {
+    if (!ensureStatus(Status::OpenReadWrite))
+      return;
+
+    LutKey k = { };
+    k.name = shader->debugName();
+    k.createInfo = shader->getShaderCreateInfo();
+
+    if (m_loweredLut.find(k) == m_loweredLut.end()) {
+      WriteEntry entry;
+      entry.irShader = std::move(shader);
+      entry.irLowered = true;
+
+      enqueueWrite(std::move(entry));
+    }
+  }
+
+
+  size_t DxvkShaderCache::prefetchShaders(
+    const std::vector<std::pair<std::string, DxvkIrShaderCreateInfo>>& keys) {
+    if (!ensureStatus(Status::OpenReadWrite))
+      return 0u;
+
+    std::vector<PrefetchEntry> entries;
+    entries.reserve(keys.size());
+
+    for (const auto& k : keys) {
+      PrefetchEntry e = { };
+      e.key.name = k.first;
+      e.key.createInfo = k.second;
+
+      auto entry = m_lut.find(e.key);
+
+      if (entry != m_lut.end()) {
+        e.entry = entry->second;
+        entries.push_back(std::move(e));
+      }
+    }
+
+    size_t count = entries.size();
+    enqueuePrefetch(std::move(entries));
+    return count;
+  }
+
+
+  size_t DxvkShaderCache::prefetchAllShaders() {
+    if (!ensureStatus(Status::OpenReadWrite))
+      return 0u;
+
+    std::vector<PrefetchEntry> entries;
+    entries.reserve(m_lut.size());
+
+    for (const auto& entry : m_lut)
+      entries.push_back({ entry.first, entry.second });
+
+    // Read entries in file order to keep disk access sequential
+    std::sort(entries.begin(), entries.end(), [] (const PrefetchEntry& a, const PrefetchEntry& b) {
+      return a.entry.offset < b.entry.offset;
+    });
+
+    size_t count = entries.size();
+    enqueuePrefetch(std::move(entries));
+    return count;
+  }
+
+
+  Rc<DxvkSpirvShader> DxvkShaderCache::lookupSpirvShader(
+    const SpirvKey&                   key,
+          std::vector<uint8_t>&       apiData) {
+    if (!ensureStatus(Status::OpenReadWrite))
+      return nullptr;
+
+    auto entry = m_spirvLut.find(key);
+
+    if (entry == m_spirvLut.end()) {
+      if (Logger::logLevel() <= LogLevel::Debug)
+        Logger::debug(str::format("Shader cache miss: ", key.name));
+
+      return nullptr;
+    }
+
+    if (Logger::logLevel() <= LogLevel::Debug) {
+      Logger::debug(str::format("Shader cache hit: ", key.name,
+        " (offset: ", entry->second.offset,
+        ", size: ", entry->second.binarySize,
+        ", metadata: ", entry->second.metadataSize, ")"));
+    }
+
+    std::unique_lock lock(m_fileMutex);
+    auto shader = loadCachedSpirvShaderLocked(entry->first, entry->second, apiData);
+
+    if (!shader) {
+      Logger::warn(str::format("Failed to load cached shader ", key.name));
+      resetLocked(key.name);
+    }
+
+    return shader;
+  }
+
+
+  std::vector<DxvkShaderCache::SpirvKey> DxvkShaderCache::getSpirvKeys(
+    const std::string&                prefix) {
+    std::vector<SpirvKey> result;
+
+    if (!ensureStatus(Status::OpenReadWrite))
+      return result;
+
+    for (const auto& entry : m_spirvLut) {
+      if (!entry.first.name.compare(0u, prefix.size(), prefix))
+        result.push_back(entry.first);
+    }
 
-      if (!m_writer.joinable())
-        m_writer = dxvk::thread([this] { runWriter(); });
+    return result;
+  }
+
+
+  void DxvkShaderCache::addSpirvShader(
+    const SpirvKey&                   key,
+          Rc<DxvkSpirvShader>         shader,
+          std::vector<uint8_t>        apiData) {
+    if (!ensureStatus(Status::OpenReadWrite))
+      return;
+
+    if (m_spirvLut.find(key) == m_spirvLut.end()) {
+      WriteEntry entry;
+      entry.spirvShader = std::move(shader);
+      entry.spirvKey = key;
+      entry.apiData = std::move(apiData);
+
+      enqueueWrite(std::move(entry));
+    }
+  }
+
+
+  void DxvkShaderCache::enqueueWrite(WriteEntry&& entry) {
+    std::unique_lock lock(m_writeMutex);
+    m_writeQueue.push(std::move(entry));
+    m_writeCond.notify_one();
+
+    if (!m_writer.joinable())
+      m_writer = dxvk::thread([this] { runWriter(); });
+  }
+
+
+  void DxvkShaderCache::enqueuePrefetch(std::vector<PrefetchEntry>&& entries) {
+    if (entries.empty())
+      return;
+
+    std::unique_lock lock(m_prefetchMutex);
+
+    for (auto& e : entries) {
+      // Null entries mark shaders that are queued but not loaded yet
+      if (m_prefetchedShaders.emplace(e.key, nullptr).second)
+        m_prefetchQueue.push(std::move(e));
+    }
+
+    m_prefetchCond.notify_one();
+
+    if (!m_prefetcher.joinable())
+      m_prefetcher = dxvk::thread([this] { runPrefetcher(); });
+  }
+
+
+  void DxvkShaderCache::runPrefetcher() {
+    env::setThreadName("dxvk-prefetch");
+
+    while (true) {
+      PrefetchEntry e;
+
+      { std::unique_lock lock(m_prefetchMutex);
+
+        m_prefetchCond.wait(lock, [this] {
+          return m_prefetchStop || !m_prefetchQueue.empty();
+        });
+
+        if (m_prefetchStop)
+          return;
+
+        e = std::move(m_prefetchQueue.front());
+        m_prefetchQueue.pop();
+
+        // Skip shaders that were looked up in the meantime
+        auto entry = m_prefetchedShaders.find(e.key);
+
+        if (entry == m_prefetchedShaders.end() || entry->second != nullptr)
+          continue;
+      }
+
+      Rc<DxvkIrShader> shader;
+
+      { std::unique_lock lock(m_fileMutex);
+
+        // The cache may have been re-created after an error, in
+        // which case the LUT entry no longer refers to valid data
+        if (m_status.load(std::memory_order_relaxed) == Status::OpenReadWrite)
+          shader = loadCachedShaderLocked(e.key, e.entry);
+      }
+
+      std::unique_lock lock(m_prefetchMutex);
+      auto entry = m_prefetchedShaders.find(e.key);
+
+      if (entry != m_prefetchedShaders.end()) {
+        if (shader)
+          entry->second = std::move(shader);
+        else
+          m_prefetchedShaders.erase(entry);
+      }
     }
   }
 
@@ -151,6 +382,19 @@ namespace dxvk {
   }
 
 
+  void DxvkShaderCache::resetLocked(const std::string& name) {
+    if (!openWriteOnlyLocked())
+      Logger::warn(str::format("Failed to re-initialize shader cache ", name));
+
+    m_status.store(Status::OpenWriteOnly, std::memory_order_release);
+
+    // Prefetched shaders came from the old file and
+    // can no longer be looked up, so free them.
+    std::unique_lock prefetchLock(m_prefetchMutex);
+    m_prefetchedShaders.clear();
+  }
+
+
   bool DxvkShaderCache::openWriteOnlyLocked() {
     // Didn't have a lot of success so far, nuke the files and retry.
     auto path = m_filePaths.directory + env::PlatformDirSlash;
@@ -186,7 +430,7 @@ namespace dxvk {
 
     LutHeader header = { };
     header.magic = { 'D', 'X', 'V', 'K' };
-    header.versionString = DXVK_VERSION;
+    header.versionString = getVersionString();
 
     if (!writeHeader(m_lutFile, header)) {
       Logger::warn(str::format("Failed to write cache header: ", path + m_filePaths.lutFile));
@@ -209,22 +453,50 @@ namespace dxvk {
       return false;
     }
 
-    if (header.versionString != DXVK_VERSION) {
+    if (header.versionString != getVersionString()) {
       Logger::warn(str::format("Cache was created with DXVK version ", header.versionString,
-        ", but current version is ", DXVK_VERSION, ". Discarding old cache."));
+        ", but current version is ", getVersionString(), ". Discarding old cache."));
       return false;
     }
 
     while (offset < size) {
-      LutKey k;
+      LutEntryType type = { };
       LutEntry e;
 
-      if (!readShaderLutEntry(k, e, offset)) {
+      bool status = read(m_lutFile, offset, type);
+
+      if (status) {
+        switch (type) {
+          case LutEntryType::IrShader: {
+            LutKey k;
+
+            if ((status = readShaderLutEntry(k, e, offset)))
+              m_lut.insert_or_assign(k, e);
+          } break;
+
+          case LutEntryType::SpirvShader: {
+            SpirvKey k;
+
+            if ((status = readSpirvShaderLutEntry(k, e, offset)))
+              m_spirvLut.insert_or_assign(k, e);
+          } break;
+
+          case LutEntryType::IrShaderLowered: {
+            LutKey k;
+
+            if ((status = readShaderLutEntry(k, e, offset)))
+              m_loweredLut.insert_or_assign(k, e);
+          } break;
+
+          default:
+            status = false;
+        }
+      }
+
+      if (!status) {
         Logger::warn("Failed to parse cache look-up table.");
         return false;
       }
-
-      m_lut.insert_or_assign(k, e);
     }
 
     return true;
@@ -285,24 +557,151 @@ namespace dxvk {
       return nullptr;
     }
 
-    return new DxvkIrShader(key.name, key.createInfo, std::move(metadata), std::move(layout), std::move(ir));
+    Rc<DxvkIrShader> shader = new DxvkIrShader(key.name, key.createInfo, std::move(metadata), std::move(layout), std::move(ir));
+
+    // Lowered code is optional, so failing to load it is not an error
+    // that requires discarding the cache. The shader can lower itself.
+    auto lowered = m_loweredLut.find(key);
+
+    if (lowered != m_loweredLut.end()) {
+      if (!loadLoweredCodeLocked(*shader, lowered->second))
+        Logger::warn(str::format("Failed to load lowered code for cached shader ", key.name));
+    }
+
+    return shader;
+  }
+
+
+  Rc<DxvkIrShader> DxvkShaderCache::takePrefetchedShader(const LutKey& key) {
+    std::unique_lock lock(m_prefetchMutex);
+
+    auto entry = m_prefetchedShaders.find(key);
+
+    if (entry == m_prefetchedShaders.end())
+      return nullptr;
+
+    // If the shader is still pending, removing the entry tells the
+    // prefetcher to skip it since we are going to load it anyway.
+    Rc<DxvkIrShader> shader = std::move(entry->second);
+    m_prefetchedShaders.erase(entry);
+    return shader;
+  }
+
+
+  Rc<DxvkSpirvShader> DxvkShaderCache::loadCachedSpirvShaderLocked(const SpirvKey& key, const LutEntry& entry, std::vector<uint8_t>& apiData) {
+    if (entry.binarySize % sizeof(uint32_t)) {
+      Logger::warn("Invalid size for cached SPIR-V binary");
+      return nullptr;
+    }
+
+    std::vector<uint32_t> code(entry.binarySize / sizeof(uint32_t));
+
+    size_t offset = entry.offset;
+
+    if (!readBytes(m_binFile, reinterpret_cast<char*>(code.data()), offset, entry.binarySize)) {
+      Logger::warn("Failed to read cached shader binary");
+      return nullptr;
+    }
+
+    if (entry.checksum != bit::fnv1a_hash(reinterpret_cast<const char*>(code.data()), entry.binarySize)) {
+      Logger::warn("Checksum mismatch for cached shader");
+      return nullptr;
+    }
+
+    DxvkSpirvShaderCreateInfo createInfo;
+    std::vector<DxvkBindingInfo> bindings;
+
+    if (!readSpirvCreateInfo(m_binFile, offset, createInfo, bindings)) {
+      Logger::warn("Failed to read cached shader metadata");
+      return nullptr;
+    }
+
+    uint32_t apiDataSize = 0u;
+
+    if (!read(m_binFile, offset, apiDataSize)) {
+      Logger::warn("Failed to read cached shader metadata");
+      return nullptr;
+    }
+
+    apiData.resize(apiDataSize);
+
+    if (!readBytes(m_binFile, apiData.data(), offset, apiDataSize)) {
+      Logger::warn("Failed to read cached shader metadata");
+      return nullptr;
+    }
+
+    createInfo.debugName = key.name;
+    return new DxvkSpirvShader(createInfo, SpirvCodeBuffer(std::move(code)));
+  }
+
+
+  bool DxvkShaderCache::loadLoweredCodeLocked(DxvkIrShader& shader, const LutEntry& entry) {
+    if (entry.binarySize % sizeof(uint32_t))
+      return false;
+
+    std::vector<uint32_t> code(entry.binarySize / sizeof(uint32_t));
+
+    size_t offset = entry.offset;
+
+    if (!readBytes(m_binFile, reinterpret_cast<char*>(code.data()), offset, entry.binarySize)
+     || entry.checksum != bit::fnv1a_hash(reinterpret_cast<const char*>(code.data()), entry.binarySize))
+      return false;
+
+    DxvkShaderBindingMap bindings;
+
+    if (!readBindingMap(m_binFile, offset, bindings))
+      return false;
+
+    SpirvCodeBuffer spirv(std::move(code));
+    shader.setLoweredCode(bindings, spirv);
+    return true;
   }
 
 
-  bool DxvkShaderCache::writeShaderLutEntry(DxvkIrShader& shader, const LutEntry& entry) {
-    return writeString(m_lutFile, shader.debugName())
+  bool DxvkShaderCache::writeShaderLutEntry(DxvkIrShader& shader, const LutEntry& entry, LutEntryType type) {
+    return write(m_lutFile, type)
+        && writeString(m_lutFile, shader.debugName())
         && writeShaderCreateInfo(m_lutFile, shader.getShaderCreateInfo())
         && write(m_lutFile, entry);
   }
 
 
+  bool DxvkShaderCache::writeSpirvShaderLutEntry(const SpirvKey& key, const LutEntry& entry) {
+    return write(m_lutFile, LutEntryType::SpirvShader)
+        && writeString(m_lutFile, key.name)
+        && write(m_lutFile, uint32_t(key.data.size()))
+        && writeBytes(m_lutFile, key.data.data(), key.data.size())
+        && write(m_lutFile, entry);
+  }
+
+
   bool DxvkShaderCache::writeShaderToCache(DxvkIrShader& shader) {
     auto entry = writeShaderBinary(m_binFile, shader);
 
     if (!entry)
       return false;
 
-    return writeShaderLutEntry(shader, *entry);
+    return writeShaderLutEntry(shader, *entry, LutEntryType::IrShader);
+  }
+
+
+  bool DxvkShaderCache::writeLoweredShaderToCache(DxvkIrShader& shader) {
+    auto entry = writeLoweredShaderBinary(m_binFile, shader);
+
+    if (!entry)
+      return false;
+
+    return writeShaderLutEntry(shader, *entry, LutEntryType::IrShaderLowered);
+  }
+
+
+  bool DxvkShaderCache::writeSpirvShaderToCache(const WriteEntry& entry) {
+    auto lutEntry = writeSpirvShaderBinary(m_binFile, *entry.spirvShader, entry.apiData);
+
+    if (!lutEntry)
+      return false;
+
+    return writeSpirvShaderLutEntry(entry.spirvKey, *lutEntry);
   }
 
 
@@ -407,6 +806,43 @@ namespace dxvk {
   }
 
 
+  bool DxvkShaderCache::readBindingMap(util::File& stream, size_t& offset, DxvkShaderBindingMap& bindings) {
+    uint32_t bindingCount = 0u;
+
+    if (!read(stream, offset, bindingCount))
+      return false;
+
+    for (uint32_t i = 0u; i < bindingCount; i++) {
+      DxvkShaderBinding srcBinding = { };
+      DxvkShaderBinding dstBinding = { };
+
+      if (!read(stream, offset, srcBinding)
+       || !read(stream, offset, dstBinding))
+        return false;
+
+      bindings.addBinding(srcBinding, dstBinding);
+    }
+
+    uint32_t pushDataCount = 0u;
+
+    if (!read(stream, offset, pushDataCount))
+      return false;
+
+    for (uint32_t i = 0u; i < pushDataCount; i++) {
+      DxvkPushDataBlock block = { };
+      uint32_t pushOffset = 0u;
+
+      if (!read(stream, offset, block)
+       || !read(stream, offset, pushOffset))
+        return false;
+
+      bindings.addPushData(block, pushOffset);
+    }
+
+    return true;
+  }
+
+
   bool DxvkShaderCache::readShaderXfbInfo(util::File& stream, size_t& offset, dxbc_spv::ir::IoXfbInfo& xfb) {
     return readString(stream, offset, xfb.semanticName)
         && read(stream, offset, xfb.semanticIndex)
@@ -436,13 +872,55 @@ namespace dxvk {
   }
 
 
+  bool DxvkShaderCache::readSpirvShaderLutKey(util::File& stream, size_t& offset, SpirvKey& key) {
+    uint32_t dataSize = 0u;
+
+    if (!readString(stream, offset, key.name)
+     || !read(stream, offset, dataSize))
+      return false;
+
+    key.data.resize(dataSize);
+    return readBytes(stream, key.data.data(), offset, dataSize);
+  }
+
+
+  bool DxvkShaderCache::readSpirvCreateInfo(util::File& stream, size_t& offset, DxvkSpirvShaderCreateInfo& createInfo, std::vector<DxvkBindingInfo>& bindings) {
+    uint32_t bindingCount = 0u;
+
+    bool status = read(stream, offset, createInfo.flatShadingInputs)
+               && read(stream, offset, createInfo.sharedPushData)
+               && read(stream, offset, createInfo.localPushData)
+               && read(stream, offset, createInfo.samplerHeap)
+               && read(stream, offset, createInfo.xfbRasterizedStream)
+               && read(stream, offset, createInfo.patchVertexCount)
+               && read(stream, offset, bindingCount);
+
+    if (!status)
+      return false;
+
+    bindings.resize(bindingCount);
+
+    for (uint32_t i = 0u; i < bindingCount; i++)
+      status = status && read(stream, offset, bindings[i]);
+
+    createInfo.bindingCount = bindingCount;
+    createInfo.bindings = bindings.data();
+    return status;
+  }
+
+
   bool DxvkShaderCache::readShaderLutEntry(LutKey& key, LutEntry& entry, size_t& offset) {
     return readShaderLutKey(m_lutFile, offset, key) && read(m_lutFile, offset, entry);
   }
 
 
+  bool DxvkShaderCache::readSpirvShaderLutEntry(SpirvKey& key, LutEntry& entry, size_t& offset) {
+    return readSpirvShaderLutKey(m_lutFile, offset, key) && read(m_lutFile, offset, entry);
+  }
+
+
   void DxvkShaderCache::runWriter() {
-    small_vector<Rc<DxvkIrShader>, 128u> localQueue;
+    small_vector<WriteEntry, 128u> localQueue;
 
     env::setThreadName("dxvk-cache");
 
@@ -460,10 +938,10 @@ namespace dxvk {
 
       lock.unlock();
 
-      stop = !entry;
+      stop = !entry.irShader && !entry.spirvShader;
       bool drain = stop;
 
-      if (entry) {
+      if (!stop) {
         localQueue.push_back(std::move(entry));
         drain = localQueue.size() == localQueue.capacity();
       }
@@ -471,8 +949,12 @@ namespace dxvk {
       if (drain) {
         std::unique_lock fileLock(m_fileMutex);
 
-        for (const auto& shader : localQueue) {
-          if (!writeShaderToCache(*shader)) {
+        for (const auto& e : localQueue) {
+          bool status = e.irShader
+            ? (e.irLowered ? writeLoweredShaderToCache(*e.irShader) : writeShaderToCache(*e.irShader))
+            : writeSpirvShaderToCache(e);
+
+          if (!status) {
             Logger::err("Failed to write cache file.");
             m_status = Status::CacheDisabled;
             return;
@@ -567,12 +1049,102 @@ namespace dxvk {
   }
 
 
+  bool DxvkShaderCache::writeSpirvCreateInfo(util::File& stream, const DxvkSpirvShaderCreateInfo& createInfo) {
+    bool status = write(stream, createInfo.flatShadingInputs)
+               && write(stream, createInfo.sharedPushData)
+               && write(stream, createInfo.localPushData)
+               && write(stream, createInfo.samplerHeap)
+               && write(stream, createInfo.xfbRasterizedStream)
+               && write(stream, createInfo.patchVertexCount)
+               && write(stream, createInfo.bindingCount);
+
+    for (uint32_t i = 0u; i < createInfo.bindingCount; i++)
+      status = status && write(stream, createInfo.bindings[i]);
+
+    return status;
+  }
+
+
+  std::optional<DxvkShaderCache::LutEntry> DxvkShaderCache::writeSpirvShaderBinary(util::File& stream, DxvkSpirvShader& shader, const std::vector<uint8_t>& apiData) {
+    SpirvCodeBuffer code = shader.getRawCode();
+
+    auto data = reinterpret_cast<const char*>(code.data());
+    auto size = code.size();
+
+    LutEntry entry = { };
+    entry.offset = stream.size();
+    entry.binarySize = size;
+
+    if (!writeBytes(stream, data, size)
+     || !writeSpirvCreateInfo(stream, shader.getCreateInfo())
+     || !write(stream, uint32_t(apiData.size()))
+     || !writeBytes(stream, apiData.data(), apiData.size()))
+      return std::nullopt;
+
+    entry.metadataSize = uint32_t(uint64_t(stream.size()) - (entry.offset + entry.binarySize));
+    entry.checksum = bit::fnv1a_hash(data, size);
+    return std::make_optional(entry);
+  }
+
+
+  std::optional<DxvkShaderCache::LutEntry> DxvkShaderCache::writeLoweredShaderBinary(util::File& stream, DxvkIrShader& shader) {
+    DxvkShaderBindingMap bindings;
+    SpirvCodeBuffer code;
+
+    if (!shader.getLoweredCode(bindings, code))
+      return std::nullopt;
+
+    auto data = reinterpret_cast<const char*>(code.data());
+    auto size = code.size();
+
+    LutEntry entry = { };
+    entry.offset = stream.size();
+    entry.binarySize = size;
+
+    if (!writeBytes(stream, data, size)
+     || !writeBindingMap(stream, bindings))
+      return std::nullopt;
+
+    entry.metadataSize = uint32_t(uint64_t(stream.size()) - (entry.offset + entry.binarySize));
+    entry.checksum = bit::fnv1a_hash(data, size);
+    return std::make_optional(entry);
+  }
+
+
+  bool DxvkShaderCache::writeBindingMap(util::File& stream, const DxvkShaderBindingMap& bindings) {
+    const auto& bindingList = bindings.getBindings();
+    const auto& pushDataList = bindings.getPushData();
+
+    bool status = write(stream, uint32_t(bindingList.size()));
+
+    for (const auto& e : bindingList) {
+      status = status && write(stream, e.first)
+                      && write(stream, e.second);
+    }
+
+    status = status && write(stream, uint32_t(pushDataList.size()));
+
+    for (const auto& e : pushDataList) {
+      status = status && write(stream, e.first)
+                      && write(stream, e.second);
+    }
+
+    return status;
+  }
+
+
   bool DxvkShaderCache::writeHeader(util::File& stream, const LutHeader& header) {
     return writeBytes(stream, header.magic.data(), header.magic.size())
         && writeString(stream, header.versionString);
   }
 
 
+  std::string DxvkShaderCache::getVersionString() {
+    // Bump the revision whenever the file format changes
+    return str::format(DXVK_VERSION, "+r3");
+  }
+
+
   DxvkShaderCache::FilePaths DxvkShaderCache::getDefaultFilePaths() {
     std::string cachePath = env::getEnvVar("DXVK_SHADER_CACHE_PATH");
 
@@ -669,4 +1241,17 @@ namespace dxvk {
     return name == k.name && createInfo.eq(k.createInfo);
   }
 
+
+  size_t DxvkShaderCache::SpirvKey::hash() const {
+    DxvkHashState hash;
+    hash.add(bit::fnv1a_hash(name.data(), name.size()));
+    hash.add(bit::fnv1a_hash(data.data(), data.size()));
+    return hash;
+  }
+
+
+  bool DxvkShaderCache::SpirvKey::eq(const SpirvKey& k) const {
+    return name == k.name && data == k.data;
+  }
+
 }
@@ -13,6 +13,7 @@
 #include "../util/util_file.h"
 
 #include "dxvk_shader_ir.h"
+#include "dxvk_shader_spirv.h"
 
 namespace dxvk {
 
@@ -24,6 +25,12 @@ namespace dxvk {
    * The implementation creates two files that can trivially grow by appending
    * data to them: A binary blob that contains the actual serialized IR as well
    * as shader metadata, and a look-up table
+   *
+   * Client APIs that generate SPIR-V directly can store their shaders in the
+   * same files, identified by an API-defined key rather than IR create info.
+   *
+   * For IR shaders, the cache can additionally store SPIR-V that was lowered
+   * for pipeline libraries, so that this does not need to be redone on load.
    */
   class DxvkShaderCache {
 
@@ -35,6 +42,28 @@ namespace dxvk {
       std::string binFile;
     };
 
+    /**
+     * \brief Look-up key for SPIR-V shaders
+     *
+     * Stores the shader name as well as an opaque blob that
+     * must contain everything that affects code generation,
+     * e.g. a bytecode hash and compile options.
+     */
+    struct SpirvKey {
+      std::string name;
+      std::vector<uint8_t> data;
+
+      template<typename T, std::enable_if_t<std::is_trivially_copyable_v<T>, bool> = true>
+      void add(const T& value) {
+        auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(value));
+      }
+
+      size_t hash() const;
+
+      bool eq(const SpirvKey& k) const;
+    };
+
     ~DxvkShaderCache();
 
     void incRef() {
@@ -66,6 +95,78 @@ namespace dxvk {
      */
     void addShader(Rc<DxvkIrShader> shader);
 
+    /**
+     * \brief Writes lowered SPIR-V for a shader to cache file
+     *
+     * Stores the shader's pre-lowered SPIR-V code alongside the
+     * binding map it was generated for. The shader itself must
+     * also be added to the cache. Will be written asynchronously.
+     * \param [in] shader Shader with lowered code
+     */
+    void addLoweredShader(Rc<DxvkIrShader> shader);
+
+    /**
+     * \brief Prefetches shaders with matching names and options
+     *
+     * Loads the given shaders from the cache on a background
+     * thread, so that subsequent look-ups for these shaders
+     * do not need to perform any file I/O. Keys that are not
+     * present in the cache are ignored.
+     * \param [in] keys Shader names and options
+     * \returns Number of shaders queued for prefetching
+     */
+    size_t prefetchShaders(
+      const std::vector<std::pair<std::string, DxvkIrShaderCreateInfo>>& keys);
+
+    /**
+     * \brief Prefetches all shaders in the cache
+     *
+     * Since the cache is per executable, this effectively loads
+     * the recorded working set of the application. Note that
+     * this keeps all cached shaders in memory until they are
+     * looked up, or until the cache is destroyed.
+     * \returns Number of shaders queued for prefetching
+     */
+    size_t prefetchAllShaders();
+
+    /**
+     * \brief Looks up SPIR-V shader with matching key
+     *
+     * \param [in] key Shader name and API-defined key
+     * \param [out] apiData API-defined data that was
+     *    stored alongside the shader, if any.
+     * \returns Shader object, or \c nullptr if the shader in
+     *    question could not be found in the cache.
+     */
+    Rc<DxvkSpirvShader> lookupSpirvShader(
+      const SpirvKey&                   key,
+            std::vector<uint8_t>&       apiData);
+
+    /**
+     * \brief Writes SPIR-V shader to cache file
+     *
+     * The shader binary will be written asynchronously.
+     * \param [in] key Shader name and API-defined key
+     * \param [in] shader Shader to write to cache
+     * \param [in] apiData API-defined data to store
+     *    alongside the shader, e.g. reflection info.
+     */
+    void addSpirvShader(
+      const SpirvKey&                   key,
+            Rc<DxvkSpirvShader>         shader,
+            std::vector<uint8_t>        apiData);
+
+    /**
+     * \brief Enumerates cached SPIR-V shader keys
+     *
+     * Allows client APIs to find shaders that were used in
+     * previous runs in order to compile them ahead of time.
+     * \param [in] prefix Shader name prefix to match
+     * \returns Keys of all matching shaders in the cache
+     */
+    std::vector<SpirvKey> getSpirvKeys(
+      const std::string&                prefix);
+
     /**
      * \brief Determines cache file path based on current environment and executable
      * \returns File paths and file names for cache files
@@ -108,6 +209,25 @@ namespace dxvk {
       uint64_t checksum = 0u;
     };
 
+    enum class LutEntryType : uint8_t {
+      IrShader        = 0u,
+      SpirvShader     = 1u,
+      IrShaderLowered = 2u,
+    };
+
+    struct WriteEntry {
+      Rc<DxvkIrShader>      irShader;
+      bool                  irLowered = false;
+      Rc<DxvkSpirvShader>   spirvShader;
+      SpirvKey              spirvKey;
+      std::vector<uint8_t>  apiData;
+    };
+
+    struct PrefetchEntry {
+      LutKey                key;
+      LutEntry              entry;
+    };
+
     enum class Status : uint32_t {
       Uninitialized   = 0u,
       CacheDisabled   = 1u,
@@ -126,13 +246,24 @@ namespace dxvk {
     std::atomic<Status>           m_status = { Status::Uninitialized };
 
     std::unordered_map<LutKey, LutEntry, DxvkHash, DxvkEq> m_lut;
+    std::unordered_map<SpirvKey, LutEntry, DxvkHash, DxvkEq> m_spirvLut;
+    std::unordered_map<LutKey, LutEntry, DxvkHash, DxvkEq> m_loweredLut;
 
     dxvk::mutex                   m_writeMutex;
     dxvk::condition_variable      m_writeCond;
-    std::queue<Rc<DxvkIrShader>>  m_writeQueue;
+    std::queue<WriteEntry>        m_writeQueue;
 
     dxvk::thread                  m_writer;
 
+    dxvk::mutex                   m_prefetchMutex;
+    dxvk::condition_variable      m_prefetchCond;
+    std::queue<PrefetchEntry>     m_prefetchQueue;
+    bool                          m_prefetchStop = false;
+
+    std::unordered_map<LutKey, Rc<DxvkIrShader>, DxvkHash, DxvkEq> m_prefetchedShaders;
+
+    dxvk::thread                  m_prefetcher;
+
     DxvkShaderCache();
 
     bool ensureStatus(Status status);
@@ -145,18 +276,40 @@ namespace dxvk {
 
     bool openWriteOnlyLocked();
 
+    void resetLocked(const std::string& name);
+
     bool parseLut();
 
     Rc<DxvkIrShader> loadCachedShaderLocked(const LutKey& key, const LutEntry& entry);
 
-    bool writeShaderLutEntry(DxvkIrShader& shader, const LutEntry& entry);
+    Rc<DxvkIrShader> takePrefetchedShader(const LutKey& key);
+
+    Rc<DxvkSpirvShader> loadCachedSpirvShaderLocked(const SpirvKey& key, const LutEntry& entry, std::vector<uint8_t>& apiData);
+
+    bool loadLoweredCodeLocked(DxvkIrShader& shader, const LutEntry& entry);
+
+    bool writeShaderLutEntry(DxvkIrShader& shader, const LutEntry& entry, LutEntryType type);
+
+    bool writeSpirvShaderLutEntry(const SpirvKey& key, const LutEntry& entry);
 
     bool writeShaderToCache(DxvkIrShader& shader);
 
+    bool writeSpirvShaderToCache(const WriteEntry& entry);
+
+    bool writeLoweredShaderToCache(DxvkIrShader& shader);
+
     bool readShaderLutEntry(LutKey& key, LutEntry& entry, size_t& offset);
 
+    bool readSpirvShaderLutEntry(SpirvKey& key, LutEntry& entry, size_t& offset);
+
+    void enqueueWrite(WriteEntry&& entry);
+
     void runWriter();
 
+    void enqueuePrefetch(std::vector<PrefetchEntry>&& entries);
+
+    void runPrefetcher();
+
     void freeInstance();
 
     static bool writeShaderXfbInfo(util::File& stream, const dxbc_spv::ir::IoXfbInfo& xfb);
@@ -171,18 +324,34 @@ namespace dxvk {
 
     static std::optional<LutEntry> writeShaderBinary(util::File& stream, DxvkIrShader& shader);
 
+    static bool writeSpirvCreateInfo(util::File& stream, const DxvkSpirvShaderCreateInfo& createInfo);
+
+    static std::optional<LutEntry> writeSpirvShaderBinary(util::File& stream, DxvkSpirvShader& shader, const std::vector<uint8_t>& apiData);
+
+    static std::optional<LutEntry> writeLoweredShaderBinary(util::File& stream, DxvkIrShader& shader);
+
+    static bool writeBindingMap(util::File& stream, const DxvkShaderBindingMap& bindings);
+
     static bool writeHeader(util::File& stream, const LutHeader& header);
 
+    static std::string getVersionString();
+
     static bool readShaderIo(util::File& stream, size_t& offset, DxvkShaderIo& io);
 
     static bool readShaderXfbInfo(util::File& stream, size_t& offset, dxbc_spv::ir::IoXfbInfo& xfb);
 
     static bool readShaderLutKey(util::File& stream, size_t& offset, LutKey& key);
 
+    static bool readSpirvShaderLutKey(util::File& stream, size_t& offset, SpirvKey& key);
+
+    static bool readSpirvCreateInfo(util::File& stream, size_t& offset, DxvkSpirvShaderCreateInfo& createInfo, std::vector<DxvkBindingInfo>& bindings);
+
     static bool readShaderMetadata(util::File& stream, size_t& offset, DxvkShaderMetadata& metadata);
 
     static bool readShaderLayout(util::File& stream, size_t& offset, DxvkPipelineLayoutBuilder& layout);
 
+    static bool readBindingMap(util::File& stream, size_t& offset, DxvkShaderBindingMap& bindings);
+
     static bool writeBytes(util::File& stream, const char* data, size_t size) {
       return stream.append(size, data);
     }
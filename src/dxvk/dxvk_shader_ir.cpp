@@ -4,6 +4,8 @@
 
 #include <util/util_log.h>
 
+#include "dxvk_compile_trace.h"
+#include "dxvk_shader_cache.h"
 #include "dxvk_shader_ir.h"
 
 namespace dxvk {
@@ -1676,6 +1678,18 @@ namespace dxvk {
     const DxvkShaderLinkage*          linkage) {
     convertIr("getCode()");
 
+    // Code without linkage info only depends on the binding map, and
+    // may have been loaded from the shader cache or generated before.
+    bool isLoweredVariant = bindings && !linkage;
+
+    if (isLoweredVariant) {
+      std::lock_guard lock(m_loweredMutex);
+
+      if (m_loweredBindings && m_loweredBindings->eq(*bindings))
+        return m_loweredCode.decompress();
+    }
+
+    DxvkCompileTraceScope trace(DxvkCompileTraceCategory::IrLower, m_debugName);
     DxvkDxbcSpirvLogger logger(debugName());
 
     dxbc_spv::ir::Builder irBuilder;
@@ -1787,7 +1801,28 @@ namespace dxvk {
     dxbc_spv::spirv::SpirvBuilder spirvBuilder(irBuilder, mapping, options);
     spirvBuilder.buildSpirvBinary();
 
-    return SpirvCodeBuffer(spirvBuilder.getSpirvBinary());
+    SpirvCodeBuffer code(spirvBuilder.getSpirvBinary());
+
+    // Keep the first lowered variant around and write it to the
+    // cache, so that subsequent runs do not have to lower it again.
+    if (isLoweredVariant) {
+      Rc<DxvkShaderCache> shaderCache;
+
+      { std::lock_guard lock(m_loweredMutex);
+
+        if (!m_loweredBindings) {
+          m_loweredBindings = *bindings;
+          m_loweredCode = SpirvCompressedBuffer(code);
+
+          shaderCache = m_shaderCache;
+        }
+      }
+
+      if (shaderCache)
+        shaderCache->addLoweredShader(this);
+    }
+
+    return code;
   }
 
 
@@ -1816,6 +1851,36 @@ namespace dxvk {
   }
 
 
+  void DxvkIrShader::setLoweredCode(
+    const DxvkShaderBindingMap&       bindings,
+          SpirvCodeBuffer&            code) {
+    std::lock_guard lock(m_loweredMutex);
+    m_loweredBindings = bindings;
+    m_loweredCode = SpirvCompressedBuffer(code);
+  }
+
+
+  bool DxvkIrShader::getLoweredCode(
+          DxvkShaderBindingMap&       bindings,
+          SpirvCodeBuffer&            code) {
+    std::lock_guard lock(m_loweredMutex);
+
+    if (!m_loweredBindings)
+      return false;
+
+    bindings = *m_loweredBindings;
+    code = m_loweredCode.decompress();
+    return true;
+  }
+
+
+  void DxvkIrShader::setShaderCache(
+          Rc<DxvkShaderCache>         cache) {
+    std::lock_guard lock(m_loweredMutex);
+    m_shaderCache = std::move(cache);
+  }
+
+
   void DxvkIrShader::convertIr(const char* reason) {
     if (m_convertedIr.load(std::memory_order_acquire))
       return;
@@ -1848,6 +1913,7 @@ namespace dxvk {
 
 
   void DxvkIrShader::convertShader() {
+    DxvkCompileTraceScope trace(DxvkCompileTraceCategory::IrConvert, m_debugName);
     DxvkDxbcSpirvLogger logger(m_debugName);
 
     dxbc_spv::ir::Builder builder;
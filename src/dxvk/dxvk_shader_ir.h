@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,8 @@
 
 namespace dxvk {
 
+  class DxvkShaderCache;
+
   /**
    * \brief IR shader properties
    *
@@ -176,6 +179,40 @@ namespace dxvk {
      */
     std::string debugName();
 
+    /**
+     * \brief Sets pre-lowered SPIR-V code
+     *
+     * Used for shaders loaded from the on-disk cache. If no linkage
+     * info is needed and the binding map matches, \c getCode will
+     * return this code without lowering the IR again.
+     * \param [in] bindings Binding map the code was generated for
+     * \param [in] code SPIR-V code
+     */
+    void setLoweredCode(
+      const DxvkShaderBindingMap&       bindings,
+            SpirvCodeBuffer&            code);
+
+    /**
+     * \brief Queries pre-lowered SPIR-V code
+     *
+     * \param [out] bindings Binding map the code was generated for
+     * \param [out] code SPIR-V code
+     * \returns \c true if lowered code is available
+     */
+    bool getLoweredCode(
+            DxvkShaderBindingMap&       bindings,
+            SpirvCodeBuffer&            code);
+
+    /**
+     * \brief Sets shader cache
+     *
+     * Lowered SPIR-V code will be written to
+     * the given cache once it becomes available.
+     * \param [in] cache Shader cache
+     */
+    void setShaderCache(
+            Rc<DxvkShaderCache>         cache);
+
   private:
 
     Rc<DxvkIrShaderConverter>     m_baseIr;
@@ -191,6 +228,11 @@ namespace dxvk {
 
     DxvkShaderMetadata            m_metadata = { };
 
+    dxvk::mutex                   m_loweredMutex;
+    Rc<DxvkShaderCache>           m_shaderCache;
+    std::optional<DxvkShaderBindingMap> m_loweredBindings;
+    SpirvCompressedBuffer         m_loweredCode;
+
     void convertIr(const char* reason);
 
     void convertShader();
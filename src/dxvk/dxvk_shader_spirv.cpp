@@ -1,16 +1,23 @@
 #include <algorithm>
+#include <array>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "dxvk_compile_trace.h"
 #include "dxvk_device.h"
 #include "dxvk_shader_spirv.h"
 
 namespace dxvk {
 
+  std::atomic<uint64_t> DxvkSpirvShader::s_codeCacheHits   = { 0u };
+  std::atomic<uint64_t> DxvkSpirvShader::s_codeCacheMisses = { 0u };
+
+
   DxvkSpirvShader::DxvkSpirvShader(
     const DxvkSpirvShaderCreateInfo&  info,
           SpirvCodeBuffer&&           spirv)
-  : m_info(info), m_layout(getShaderStage(spirv)) {
+  : m_info(info), m_bindings(info.bindings, info.bindings + info.bindingCount),
+    m_layout(getShaderStage(spirv)) {
     m_info.bindings = nullptr;
 
     SpirvCodeBuffer code = std::move(spirv);
@@ -61,6 +68,69 @@ namespace dxvk {
 
 
   SpirvCodeBuffer DxvkSpirvShader::getCode(
+    const DxvkShaderBindingMap*       bindings,
+    const DxvkShaderLinkage*          linkage) {
+    size_t bindingHash = bindings ? bindings->hash() : 0u;
+
+    // Shaders are commonly used with many pipelines that share the same
+    // layout and linkage, so avoid patching the same variant repeatedly.
+    { std::unique_lock lock(m_codeCacheMutex);
+
+      for (auto e = m_codeCache.begin(); e != m_codeCache.end(); e++) {
+        if (isSameVariant(*e, bindings, bindingHash, linkage)) {
+          m_codeCache.splice(m_codeCache.begin(), m_codeCache, e);
+
+          // Decompress outside the lock, the compressed
+          // buffer is not modified after insertion
+          SpirvCompressedBuffer code = m_codeCache.front().code;
+          lock.unlock();
+
+          s_codeCacheHits += 1u;
+          return code.decompress();
+        }
+      }
+    }
+
+    s_codeCacheMisses += 1u;
+
+    SpirvCodeBuffer spirvCode;
+
+    { DxvkCompileTraceScope trace(DxvkCompileTraceCategory::SpirvPatch, m_debugName);
+      spirvCode = patchCode(bindings, linkage);
+    }
+
+    CodeCacheEntry entry;
+    entry.bindingHash = bindingHash;
+    entry.hasBindings = bindings != nullptr;
+    entry.hasLinkage = linkage != nullptr;
+
+    if (bindings)
+      entry.bindings = *bindings;
+
+    if (linkage)
+      entry.linkage = *linkage;
+
+    entry.code = SpirvCompressedBuffer(spirvCode);
+
+    std::lock_guard lock(m_codeCacheMutex);
+    m_codeCache.push_front(std::move(entry));
+
+    if (m_codeCache.size() > MaxCachedVariants)
+      m_codeCache.pop_back();
+
+    return spirvCode;
+  }
+
+
+  DxvkSpirvCodeCacheStats DxvkSpirvShader::getCodeCacheStats() {
+    DxvkSpirvCodeCacheStats result;
+    result.hits = s_codeCacheHits.load(std::memory_order_relaxed);
+    result.misses = s_codeCacheMisses.load(std::memory_order_relaxed);
+    return result;
+  }
+
+
+  SpirvCodeBuffer DxvkSpirvShader::patchCode(
     const DxvkShaderBindingMap*       bindings,
     const DxvkShaderLinkage*          linkage) {
     SpirvCodeBuffer spirvCode = m_code.decompress();
@@ -101,13 +171,58 @@ namespace dxvk {
   }
 
 
+  bool DxvkSpirvShader::isSameVariant(
+    const CodeCacheEntry&           entry,
+    const DxvkShaderBindingMap*     bindings,
+          size_t                    bindingHash,
+    const DxvkShaderLinkage*        linkage) {
+    if (entry.hasBindings != (bindings != nullptr)
+     || entry.hasLinkage != (linkage != nullptr)
+     || entry.bindingHash != bindingHash)
+      return false;
+
+    // DxvkShaderLinkage::eq does not consider all properties
+    // that affect patching, so check the remaining ones here.
+    if (linkage) {
+      if (!entry.linkage.eq(*linkage)
+       || entry.linkage.semanticIo != linkage->semanticIo
+       || entry.linkage.inputTopology != linkage->inputTopology
+       || entry.linkage.prevStage != linkage->prevStage)
+        return false;
+    }
+
+    return !bindings || entry.bindings.eq(*bindings);
+  }
+
+
   DxvkPipelineLayoutBuilder DxvkSpirvShader::getLayout() {
     return m_layout;
   }
 
 
+  DxvkSpirvShaderCreateInfo DxvkSpirvShader::getCreateInfo() const {
+    DxvkSpirvShaderCreateInfo info = m_info;
+    info.bindingCount = m_bindings.size();
+    info.bindings = m_bindings.data();
+    return info;
+  }
+
+
+  SpirvCodeBuffer DxvkSpirvShader::getRawCode() const {
+    return m_code.decompress();
+  }
+
+
   void DxvkSpirvShader::dump(std::ostream& outputStream) {
-    m_code.decompress().store(outputStream);
+    // Decode in small chunks rather than materializing the whole module
+    std::array<uint32_t, 1024> chunk;
+
+    for (size_t offset = 0u; offset < m_code.dwords(); offset += chunk.size()) {
+      size_t count = std::min(chunk.size(), m_code.dwords() - offset);
+      m_code.decompressRange(offset, count, chunk.data());
+
+      outputStream.write(reinterpret_cast<const char*>(chunk.data()), sizeof(uint32_t) * count);
+    }
   }
 
 
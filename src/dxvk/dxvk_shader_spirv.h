@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <list>
 #include <optional>
 
 #include "dxvk_shader.h"
@@ -49,11 +51,21 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Patched SPIR-V code cache stats
+   */
+  struct DxvkSpirvCodeCacheStats {
+    uint64_t hits   = 0u;
+    uint64_t misses = 0u;
+  };
+
+
   /**
    * \brief SPIR-V shader
    */
   class DxvkSpirvShader : public DxvkShader {
-
+    /** Number of patched code variants to keep per shader */
+    constexpr static size_t MaxCachedVariants = 4u;
   public:
 
     DxvkSpirvShader(
@@ -98,6 +110,21 @@ namespace dxvk {
      */
     DxvkPipelineLayoutBuilder getLayout();
 
+    /**
+     * \brief Queries create info
+     *
+     * Used to serialize the shader. The binding
+     * array is owned by the shader object.
+     * \returns Shader create info
+     */
+    DxvkSpirvShaderCreateInfo getCreateInfo() const;
+
+    /**
+     * \brief Queries unpatched SPIR-V code
+     * \returns Uncompressed SPIR-V code buffer
+     */
+    SpirvCodeBuffer getRawCode() const;
+
     /**
      * \brief Dumps SPIR-V binary to a stream
      * \param [in] outputStream Stream to write to
@@ -110,9 +137,30 @@ namespace dxvk {
      */
     std::string debugName();
 
+    /**
+     * \brief Queries patched code cache stats
+     *
+     * Accumulated over all SPIR-V shaders.
+     * \returns Cache hit and miss counts
+     */
+    static DxvkSpirvCodeCacheStats getCodeCacheStats();
+
   private:
 
+    struct CodeCacheEntry {
+      size_t                bindingHash = 0u;
+      bool                  hasBindings = false;
+      DxvkShaderBindingMap  bindings;
+      bool                  hasLinkage  = false;
+      DxvkShaderLinkage     linkage     = { };
+      SpirvCompressedBuffer code;
+    };
+
+    static std::atomic<uint64_t>  s_codeCacheHits;
+    static std::atomic<uint64_t>  s_codeCacheMisses;
+
     DxvkSpirvShaderCreateInfo     m_info  = { };
+    std::vector<DxvkBindingInfo>  m_bindings;
 
     SpirvCompressedBuffer         m_code;
     DxvkPipelineLayoutBuilder     m_layout;
@@ -125,6 +173,19 @@ namespace dxvk {
     std::unordered_multimap<uint32_t, DxvkSpirvDecorations> m_decorations = { };
     std::unordered_map<uint32_t, uint32_t> m_idToOffset = { };
 
+    dxvk::mutex                   m_codeCacheMutex;
+    std::list<CodeCacheEntry>     m_codeCache;
+
+    SpirvCodeBuffer patchCode(
+      const DxvkShaderBindingMap*     bindings,
+      const DxvkShaderLinkage*        linkage);
+
+    static bool isSameVariant(
+      const CodeCacheEntry&           entry,
+      const DxvkShaderBindingMap*     bindings,
+            size_t                    bindingHash,
+      const DxvkShaderLinkage*        linkage);
+
     void gatherIdOffsets(
             SpirvCodeBuffer&          code);
 
@@ -457,6 +457,7 @@ namespace dxvk {
     const DxvkSparseBufferBindKey& key,
     const DxvkResourceMemoryInfo& memory) {
     m_bufferBinds.insert_or_assign(key, memory);
+    m_bindRequests += 1;
   }
 
 
@@ -464,6 +465,7 @@ namespace dxvk {
     const DxvkSparseImageBindKey& key,
     const DxvkResourceMemoryInfo& memory) {
     m_imageBinds.insert_or_assign(key, memory);
+    m_bindRequests += 1;
   }
 
 
@@ -471,6 +473,7 @@ namespace dxvk {
     const DxvkSparseImageOpaqueBindKey& key,
     const DxvkResourceMemoryInfo& memory) {
     m_imageOpaqueBinds.insert_or_assign(key, memory);
+    m_bindRequests += 1;
   }
 
 
@@ -543,6 +546,8 @@ namespace dxvk {
     m_signalSemaphoreValues.clear();
     m_signalSemaphores.clear();
 
+    m_bindRequests = 0;
+
     m_bufferBinds.clear();
     m_imageBinds.clear();
     m_imageOpaqueBinds.clear();
@@ -989,6 +989,28 @@ namespace dxvk {
             DxvkDevice*             device,
             VkQueue                 queue);
 
+    /**
+     * \brief Queries number of recorded page binds
+     *
+     * Counts every bind operation, including ones
+     * that were later overridden for the same page.
+     * \returns Number of bind operations
+     */
+    uint64_t getBindRequestCount() const {
+      return m_bindRequests;
+    }
+
+    /**
+     * \brief Queries number of unique page binds
+     *
+     * Only the last bind to any given page is kept, so this
+     * is the number of binds that will actually be processed.
+     * \returns Number of unique bind operations
+     */
+    uint64_t getBindCount() const {
+      return m_bufferBinds.size() + m_imageBinds.size() + m_imageOpaqueBinds.size();
+    }
+
     /**
      * \brief Resets object
      *
@@ -1003,6 +1025,8 @@ namespace dxvk {
     std::vector<uint64_t>     m_signalSemaphoreValues;
     std::vector<VkSemaphore>  m_signalSemaphores;
 
+    uint64_t                  m_bindRequests = 0;
+
     std::map<DxvkSparseBufferBindKey,      DxvkResourceMemoryInfo> m_bufferBinds;
     std::map<DxvkSparseImageBindKey,       DxvkResourceMemoryInfo> m_imageBinds;
     std::map<DxvkSparseImageOpaqueBindKey, DxvkResourceMemoryInfo> m_imageOpaqueBinds;
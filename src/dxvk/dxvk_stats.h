@@ -21,6 +21,8 @@ namespace dxvk {
     PipeCountCompute,         ///< Number of compute pipelines
     PipeTasksDone,            ///< Boolean indicating compiler activity
     PipeTasksTotal,           ///< Boolean indicating compiler activity
+    PipeSpirvCacheHits,       ///< Patched SPIR-V served from shader cache
+    PipeSpirvCacheMisses,     ///< Patched SPIR-V generated from scratch
     QueueSubmitCount,         ///< Number of command buffer submissions
     QueuePresentCount,        ///< Number of present calls / frames
     GpuSyncCount,             ///< Number of GPU synchronizations
@@ -29,6 +31,7 @@ namespace dxvk {
     CsSyncCount,              ///< CS thread synchronizations
     CsSyncTicks,              ///< Time spent waiting on CS
     CsIdleTicks,              ///< CS thread idle time in microseconds
+    PresentSyncTicks,         ///< Time spent waiting on frame pacing
     CsChunkCount,             ///< Submitted CS chunks
     DescriptorPoolCount,      ///< Descriptor pool count
     DescriptorSetCount,       ///< Descriptor sets allocated
@@ -36,6 +39,9 @@ namespace dxvk {
     DescriptorHeapSize,       ///< Amount of descriptor memory allocated
     DescriptorHeapUsed,       ///< Amount of descriptor memory used
     DescriptorCopyBusyTicks,  ///< Descriptor copy busy time in microseconds
+    SparseBindCount,          ///< Number of sparse binding submissions
+    SparseBindPages,          ///< Number of page binds recorded
+    SparseBindPagesUnique,    ///< Number of page binds after coalescing
 
     NumCounters               ///< Number of counters available
   };
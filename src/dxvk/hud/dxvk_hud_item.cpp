@@ -576,9 +576,20 @@ namespace dxvk::hud {
     m_maxSyncCount = std::max(m_maxSyncCount, currSyncCount - m_prevSyncCount);
     m_maxSyncTicks = std::max(m_maxSyncTicks, currSyncTicks - m_prevSyncTicks);
 
+    uint64_t currSparseCount = counters.getCtr(DxvkStatCounter::SparseBindCount);
+    uint64_t currSparsePages = counters.getCtr(DxvkStatCounter::SparseBindPages);
+    uint64_t currSparseUnique = counters.getCtr(DxvkStatCounter::SparseBindPagesUnique);
+
+    m_maxSparseCount = std::max(m_maxSparseCount, currSparseCount - m_prevSparseCount);
+    m_sparsePages += currSparsePages - m_prevSparsePages;
+    m_sparseUnique += currSparseUnique - m_prevSparseUnique;
+
     m_prevSubmitCount = currSubmitCount;
     m_prevSyncCount = currSyncCount;
     m_prevSyncTicks = currSyncTicks;
+    m_prevSparseCount = currSparseCount;
+    m_prevSparsePages = currSparsePages;
+    m_prevSparseUnique = currSparseUnique;
 
     auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_lastUpdate);
 
@@ -591,9 +602,23 @@ namespace dxvk::hud {
         ? str::format(m_maxSyncCount, " (", (syncTicks / 10), ".", (syncTicks % 10), " ms)")
         : str::format(m_maxSyncCount);
 
+      // Only show sparse binding stats for apps that use the feature.
+      // The merge ratio is the number of recorded binds per page bind
+      // that actually gets submitted after coalescing.
+      if (m_sparsePages) {
+        uint64_t ratio = (10 * m_sparsePages) / std::max<uint64_t>(m_sparseUnique, 1);
+        m_sparseString = str::format(m_maxSparseCount, " (", ratio / 10, ".", ratio % 10, "x merged)");
+      } else {
+        m_sparseString.clear();
+      }
+
       m_maxSubmitCount = 0;
       m_maxSyncCount = 0;
       m_maxSyncTicks = 0;
+      m_maxSparseCount = 0;
+
+      m_sparsePages = 0;
+      m_sparseUnique = 0;
 
       m_lastUpdate = time;
     }
@@ -614,6 +639,12 @@ namespace dxvk::hud {
     renderer.drawText(16, position, 0xff4080ff, "Queue syncs:");
     renderer.drawText(16, { position.x + 228, position.y }, 0xffffffffu, m_syncString);
 
+    if (!m_sparseString.empty()) {
+      position.y += 20;
+      renderer.drawText(16, position, 0xff4080ff, "Sparse binds:");
+      renderer.drawText(16, { position.x + 228, position.y }, 0xffffffffu, m_sparseString);
+    }
+
     position.y += 8;
     return position;
   }
@@ -377,12 +377,21 @@ namespace dxvk::hud {
     uint64_t        m_prevSyncCount   = 0;
     uint64_t        m_prevSyncTicks   = 0;
 
+    uint64_t        m_prevSparseCount = 0;
+    uint64_t        m_prevSparsePages = 0;
+    uint64_t        m_prevSparseUnique = 0;
+
     uint64_t        m_maxSubmitCount  = 0;
     uint64_t        m_maxSyncCount    = 0;
     uint64_t        m_maxSyncTicks    = 0;
+    uint64_t        m_maxSparseCount  = 0;
+
+    uint64_t        m_sparsePages     = 0;
+    uint64_t        m_sparseUnique    = 0;
 
     std::string     m_submitString;
     std::string     m_syncString;
+    std::string     m_sparseString;
 
     dxvk::high_resolution_clock::time_point m_lastUpdate
       = dxvk::high_resolution_clock::now();
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 #include "spirv_compression.h"
 
 namespace dxvk {
@@ -19,6 +23,7 @@ namespace dxvk {
     std::array<uint32_t, 16> block;
     uint32_t blockMask = 0;
     uint32_t blockOffset = 0;
+    uint32_t blockDwords = 0;
 
     // The algorithm used is a simple variable-to-fixed compression that
     // encodes up to two consecutive SPIR-V tokens into one DWORD using
@@ -58,13 +63,22 @@ namespace dxvk {
         blockMask |= schema << (blockOffset << 1);
         blockOffset += 1;
 
+        blockDwords += schema ? 2 : 1;
         i += schema ? 2 : 1;
       } else {
         block[blockOffset] = data[i++];
         blockOffset += 1;
+        blockDwords += 1;
       }
 
       if (unlikely(blockOffset == 16) || unlikely(i == m_size)) {
+        // Store the uncompressed offset of every few blocks so
+        // that we can quickly locate the block for any dword
+        if (!((m_code.size() / BlockSize) % BlocksPerIndexEntry))
+          m_index.push_back(uint32_t(i - blockDwords));
+
+        blockDwords = 0;
+
         m_code.insert(m_code.end(), blockMask);
         m_code.insert(m_code.end(), block.begin(), block.begin() + blockOffset);
 
@@ -78,6 +92,8 @@ namespace dxvk {
     // too small. In general, we want to avoid reallocation here.
     if (m_code.capacity() > (m_code.size() * 10) / 9)
       m_code.shrink_to_fit();
+
+    m_index.shrink_to_fit();
   }
 
     
@@ -90,34 +106,98 @@ namespace dxvk {
     SpirvCodeBuffer code(m_size);
     uint32_t* data = code.data();
 
-    uint32_t srcOffset = 0;
-    uint32_t dstOffset = 0;
+    size_t srcOffset = 0;
+    size_t dstOffset = 0;
+
+    while (dstOffset < m_size) {
+      dstOffset += decodeBlock(&m_code[srcOffset], &data[dstOffset], m_size - dstOffset);
+      srcOffset += BlockSize;
+    }
+
+    return code;
+  }
+
+
+  void SpirvCompressedBuffer::decompressRange(
+          size_t                offset,
+          size_t                count,
+          uint32_t*             dst) const {
+    size_t end = std::min(offset + count, m_size);
+
+    if (offset >= end)
+      return;
+
+    // Find last index entry that starts at or before the requested
+    // offset. The first entry is always 0, so this is never empty.
+    auto entry = std::upper_bound(m_index.begin(), m_index.end(), uint32_t(offset)) - 1;
+
+    size_t srcOffset = size_t(entry - m_index.begin()) * BlocksPerIndexEntry * BlockSize;
+    size_t dstOffset = *entry;
+
+    std::array<uint32_t, MaxBlockDwords> block;
+
+    while (dstOffset < end) {
+      uint32_t blockDwords = decodeBlock(&m_code[srcOffset], block.data(), m_size - dstOffset);
 
+      // Copy the part of the block that overlaps the requested range
+      size_t copyBegin = std::max(dstOffset, offset);
+      size_t copyEnd = std::min(dstOffset + blockDwords, end);
+
+      if (copyBegin < copyEnd) {
+        std::memcpy(&dst[copyBegin - offset], &block[copyBegin - dstOffset],
+          sizeof(uint32_t) * (copyEnd - copyBegin));
+      }
+
+      srcOffset += BlockSize;
+      dstOffset += blockDwords;
+    }
+  }
+
+
+  uint32_t SpirvCompressedBuffer::decodeBlock(
+    const uint32_t*             src,
+          uint32_t*             dst,
+          size_t                dstSize) {
     constexpr uint32_t shiftAmounts = 0x0c101420;
 
-    while (dstOffset < m_size) {
-      uint32_t blockMask = m_code[srcOffset];
+    uint32_t blockMask = src[0];
+    uint32_t dstOffset = 0;
 
-      for (uint32_t i = 0; i < 16 && dstOffset < m_size; i++) {
+    if (likely(dstSize >= MaxBlockDwords)) {
+      // Fast path for all but the last block. Unconditionally write both
+      // halves of each token so that the loop has no data-dependent
+      // branches, the second dword is overwritten by the next token if
+      // the token only encoded a single dword.
+      for (uint32_t i = 0; i < 16; i++) {
         // Use 64-bit integers for some of the operands so we can
         // shift by 32 bits and not handle it as a special cases
         uint32_t schema = (blockMask >> (i << 1)) & 0x3;
         uint32_t shift  = (shiftAmounts >> (schema << 3)) & 0xff;
         uint64_t mask   = ~(~0ull << shift);
-        uint64_t encode = m_code[srcOffset + i + 1];
+        uint64_t encode = src[i + 1];
 
-        data[dstOffset] = encode & mask;
+        dst[dstOffset + 0] = encode & mask;
+        dst[dstOffset + 1] = encode >> shift;
+
+        dstOffset += 1u + uint32_t(schema != 0);
+      }
+    } else {
+      for (uint32_t i = 0; i < 16 && dstOffset < dstSize; i++) {
+        uint32_t schema = (blockMask >> (i << 1)) & 0x3;
+        uint32_t shift  = (shiftAmounts >> (schema << 3)) & 0xff;
+        uint64_t mask   = ~(~0ull << shift);
+        uint64_t encode = src[i + 1];
+
+        dst[dstOffset] = encode & mask;
 
         if (likely(schema))
-          data[dstOffset + 1] = encode >> shift;
+          dst[dstOffset + 1] = encode >> shift;
 
         dstOffset += schema ? 2 : 1;
       }
-
-      srcOffset += 17;
     }
 
-    return code;
+    return dstOffset;
   }
 
 }
\ No newline at end of file
@@ -13,7 +13,12 @@ namespace dxvk {
    * to keep memory footprint low.
    */
   class SpirvCompressedBuffer {
-
+    /** Number of compressed blocks per index entry */
+    constexpr static size_t BlocksPerIndexEntry = 8u;
+    /** Compressed block size, including the layout dword */
+    constexpr static size_t BlockSize = 17u;
+    /** Maximum number of dwords a single block decodes to */
+    constexpr static size_t MaxBlockDwords = 32u;
   public:
 
     SpirvCompressedBuffer();
@@ -21,17 +26,46 @@ namespace dxvk {
     SpirvCompressedBuffer(SpirvCodeBuffer& code);
     
     ~SpirvCompressedBuffer();
-    
+
+    /**
+     * \brief Queries uncompressed size
+     * \returns Uncompressed size, in dwords
+     */
+    size_t dwords() const {
+      return m_size;
+    }
+
+    /**
+     * \brief Decompresses the entire buffer
+     * \returns Uncompressed code buffer
+     */
     SpirvCodeBuffer decompress() const;
 
+    /**
+     * \brief Decompresses a range of dwords
+     *
+     * Only decodes the blocks overlapping the given range,
+     * which can be located without decoding the preceding
+     * data thanks to a small block index.
+     * \param [in] offset Index of first dword to decode
+     * \param [in] count Number of dwords to decode
+     * \param [out] dst Output array for \c count dwords
+     */
+    void decompressRange(
+            size_t                offset,
+            size_t                count,
+            uint32_t*             dst) const;
+
   private:
 
     size_t                m_size;
     std::vector<uint32_t> m_code;
+    std::vector<uint32_t> m_index;
 
-    void encodeDword(uint32_t dw);
-
-    uint32_t decodeDword(size_t& offset) const;
+    static uint32_t decodeBlock(
+      const uint32_t*             src,
+            uint32_t*             dst,
+            size_t                dstSize);
 
   };
 
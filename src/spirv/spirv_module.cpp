@@ -3865,19 +3865,17 @@ namespace dxvk {
           spv::Op                 op, 
           uint32_t                argCount,
     const uint32_t*               argIds) {
-    // Since the type info is stored in the code buffer,
-    // we can use the code buffer to look up type IDs as
-    // well. Result IDs are always stored as argument 1.
-    for (auto ins : m_typeConstDefs) {
-      bool match = ins.opCode() == op
-                && ins.length() == 2 + argCount;
-      
-      for (uint32_t i = 0; i < argCount && match; i++)
-        match &= ins.arg(2 + i) == argIds[i];
-      
-      if (match && m_uniqueTypes.find(ins.arg(1)) == m_uniqueTypes.end())
-        return ins.arg(1);
-    }
+    // Look up existing declarations by opcode and operands. Types
+    // created as unique are never added to the lookup table.
+    std::vector<uint32_t> key;
+    key.reserve(1 + argCount);
+    key.push_back(uint32_t(op));
+    key.insert(key.end(), argIds, argIds + argCount);
+
+    auto entry = m_typeConstIds.find(key);
+
+    if (entry != m_typeConstIds.end())
+      return entry->second;
     
     // Type not yet declared, create a new one.
     uint32_t resultId = this->allocateId();
@@ -3886,6 +3884,8 @@ namespace dxvk {
     
     for (uint32_t i = 0; i < argCount; i++)
       m_typeConstDefs.putWord(argIds[i]);
+
+    m_typeConstIds.insert({ std::move(key), resultId });
     return resultId;
   }
   
@@ -3895,23 +3895,18 @@ namespace dxvk {
           uint32_t                typeId,
           uint32_t                argCount,
     const uint32_t*               argIds) {
-    // Avoid declaring constants multiple times
-    for (auto ins : m_typeConstDefs) {
-      bool match = ins.opCode() == op
-                && ins.length() == 3 + argCount
-                && ins.arg(1)   == typeId;
-      
-      for (uint32_t i = 0; i < argCount && match; i++)
-        match &= ins.arg(3 + i) == argIds[i];
-      
-      if (!match)
-        continue;
-      
-      uint32_t id = ins.arg(2);
+    // Avoid declaring constants multiple times. Late constants
+    // can change their value, so those are never looked up.
+    std::vector<uint32_t> key;
+    key.reserve(2 + argCount);
+    key.push_back(uint32_t(op));
+    key.push_back(typeId);
+    key.insert(key.end(), argIds, argIds + argCount);
 
-      if (m_lateConsts.find(id) == m_lateConsts.end())
-        return id;
-    }
+    auto entry = m_typeConstIds.find(key);
+
+    if (entry != m_typeConstIds.end())
+      return entry->second;
     
     // Constant not yet declared, make a new one
     uint32_t resultId = this->allocateId();
@@ -3921,6 +3916,8 @@ namespace dxvk {
     
     for (uint32_t i = 0; i < argCount; i++)
       m_typeConstDefs.putWord(argIds[i]);
+
+    m_typeConstIds.insert({ std::move(key), resultId });
     return resultId;
   }
   
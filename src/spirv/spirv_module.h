@@ -41,6 +41,23 @@ namespace dxvk {
     bool     sparse        = false;
   };
 
+  /**
+   * \brief Hash function for type and constant declarations
+   *
+   * Keys consist of the opcode followed by all operands
+   * of the declaration, excluding the result ID.
+   */
+  struct SpirvTypeConstHash {
+    size_t operator () (const std::vector<uint32_t>& words) const {
+      size_t hash = 0;
+
+      for (uint32_t word : words)
+        hash = (hash * 31u) ^ word;
+
+      return hash;
+    }
+  };
+
   constexpr uint32_t spvVersion(uint32_t major, uint32_t minor) {
     return (major << 16) | (minor << 8);
   }
@@ -1311,6 +1328,9 @@ namespace dxvk {
     std::unordered_set<uint32_t> m_uniqueTypes;
     std::unordered_set<uint32_t> m_lateConsts;
 
+    std::unordered_map<std::vector<uint32_t>,
+      uint32_t, SpirvTypeConstHash> m_typeConstIds;
+
     std::vector<uint32_t> m_interfaceVars;
 
     uint32_t defType(
@@ -0,0 +1,171 @@
+#include <unordered_map>
+#include <unordered_set>
+
+#include "spirv_optimize.h"
+
+namespace dxvk {
+
+  struct SpirvLocalVarInfo {
+    bool      isPrivate = false;
+    bool      eligible  = true;
+    uint32_t  loadCount = 0u;
+  };
+
+
+  SpirvCodeBuffer spirvForwardLocalVariables(
+          SpirvCodeBuffer&          code) {
+    std::unordered_map<uint32_t, SpirvLocalVarInfo> vars;
+
+    // Gather all local variables in the module
+    for (auto ins : code) {
+      if (ins.opCode() != spv::OpVariable)
+        continue;
+
+      auto storage = spv::StorageClass(ins.arg(3));
+
+      if (storage == spv::StorageClassFunction || storage == spv::StorageClassPrivate)
+        vars.insert({ ins.arg(2), SpirvLocalVarInfo { storage == spv::StorageClassPrivate } });
+    }
+
+    if (vars.empty())
+      return code;
+
+    // Exclude any variable that is used by anything other than a plain
+    // load or store. This also catches access chains and function call
+    // parameters. Literal operands may coincidentally match a variable
+    // ID, which is harmless since it only makes this more conservative.
+    for (auto ins : code) {
+      uint32_t ignoreArg = 0u;
+
+      switch (ins.opCode()) {
+        case spv::OpName:
+        case spv::OpDecorate:
+        case spv::OpEntryPoint:
+          continue;
+
+        case spv::OpVariable: ignoreArg = 2u; break;
+        case spv::OpLoad:     ignoreArg = 3u; break;
+        case spv::OpStore:    ignoreArg = 1u; break;
+
+        default:
+          break;
+      }
+
+      for (uint32_t i = 1; i < ins.length(); i++) {
+        if (i == ignoreArg)
+          continue;
+
+        auto entry = vars.find(ins.arg(i));
+
+        if (entry != vars.end())
+          entry->second.eligible = false;
+      }
+    }
+
+    // Track known variable contents within each block. Loads with known
+    // values are replaced, stores that are overwritten before the next
+    // load within the same block are removed.
+    std::unordered_map<uint32_t, uint32_t> knownValues;
+    std::unordered_map<uint32_t, uint32_t> pendingStores;
+
+    std::unordered_map<uint32_t, uint32_t> forwardedLoads;
+    std::unordered_set<uint32_t> deadStores;
+
+    for (auto ins : code) {
+      switch (ins.opCode()) {
+        case spv::OpLabel:
+        case spv::OpFunction:
+        case spv::OpFunctionEnd:
+        case spv::OpFunctionCall: {
+          // Function calls may access private variables
+          knownValues.clear();
+          pendingStores.clear();
+        } break;
+
+        case spv::OpLoad: {
+          auto var = vars.find(ins.arg(3));
+
+          if (var == vars.end() || !var->second.eligible)
+            break;
+
+          pendingStores.erase(var->first);
+
+          // Do not touch loads with memory operands
+          auto value = knownValues.find(var->first);
+
+          if (value != knownValues.end() && ins.length() == 4u) {
+            forwardedLoads.insert({ ins.offset(), value->second });
+          } else {
+            knownValues.insert_or_assign(var->first, ins.arg(2));
+            var->second.loadCount += 1u;
+          }
+        } break;
+
+        case spv::OpStore: {
+          auto var = vars.find(ins.arg(1));
+
+          if (var == vars.end() || !var->second.eligible)
+            break;
+
+          auto store = pendingStores.find(var->first);
+
+          if (store != pendingStores.end())
+            deadStores.insert(store->second);
+
+          if (ins.length() == 3u) {
+            pendingStores.insert_or_assign(var->first, ins.offset());
+            knownValues.insert_or_assign(var->first, ins.arg(2));
+          } else {
+            pendingStores.erase(var->first);
+            knownValues.erase(var->first);
+          }
+        } break;
+
+        default:
+          break;
+      }
+    }
+
+    // Rebuild the module, keeping the header as-is
+    std::vector<uint32_t> result;
+    result.reserve(code.dwords());
+
+    if (code.dwords() >= 5u && code.data()[0] == spv::MagicNumber)
+      result.insert(result.end(), code.data(), code.data() + 5u);
+
+    for (auto ins : code) {
+      if (ins.opCode() == spv::OpLoad) {
+        auto entry = forwardedLoads.find(ins.offset());
+
+        if (entry != forwardedLoads.end()) {
+          result.push_back(spv::OpCopyObject | (4u << spv::WordCountShift));
+          result.push_back(ins.arg(1));
+          result.push_back(ins.arg(2));
+          result.push_back(entry->second);
+          continue;
+        }
+      } else if (ins.opCode() == spv::OpStore) {
+        if (deadStores.find(ins.offset()) != deadStores.end())
+          continue;
+
+        // Remove all stores to variables that are never read
+        auto var = vars.find(ins.arg(1));
+
+        if (var != vars.end() && var->second.eligible && !var->second.loadCount)
+          continue;
+      }
+
+      for (uint32_t i = 0; i < ins.length(); i++)
+        result.push_back(ins.arg(i));
+    }
+
+    return SpirvCodeBuffer(std::move(result));
+  }
+
+
+  SpirvCodeBuffer spirvOptimize(
+          SpirvCodeBuffer&          code) {
+    return spirvForwardLocalVariables(code);
+  }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "spirv_code_buffer.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Forwards local variable loads and removes dead stores
+   *
+   * Only considers function- and private-scope variables that
+   * are exclusively accessed as a whole via \c OpLoad and
+   * \c OpStore, which is the case for most temporary registers
+   * in generated shaders. Within each block, loads are replaced
+   * with the value last stored to or loaded from the variable,
+   * and stores that are overwritten before being read are
+   * removed. Stores to variables that are never read at all
+   * are removed as well.
+   * \param [in] code Shader code
+   * \returns Optimized shader code
+   */
+  SpirvCodeBuffer spirvForwardLocalVariables(
+          SpirvCodeBuffer&          code);
+
+  /**
+   * \brief Runs all SPIR-V optimization passes
+   *
+   * Intended to reduce the amount of redundant code that
+   * drivers have to deal with when compiling shaders that
+   * are generated with a straightforward translation.
+   * \param [in] code Shader code
+   * \returns Optimized shader code
+   */
+  SpirvCodeBuffer spirvOptimize(
+          SpirvCodeBuffer&          code);
+
+}
@@ -7,6 +7,7 @@
 #include "../rc/util_rc.h"
 
 #include "../thread.h"
+#include "../util_time.h"
 
 namespace dxvk::sync {
   
@@ -170,6 +171,38 @@ namespace dxvk::sync {
       });
     }
 
+    template<typename Rep, typename Period>
+    bool wait(uint64_t value, const std::chrono::duration<Rep, Period>& timeout) {
+      if (value <= m_value.load(std::memory_order_acquire))
+        return true;
+
+      auto deadline = dxvk::high_resolution_clock::now() + timeout;
+
+      std::unique_lock<dxvk::mutex> lock(m_mutex);
+
+      while (value > m_value.load(std::memory_order_acquire)) {
+        auto now = dxvk::high_resolution_clock::now();
+
+        if (now >= deadline)
+          return false;
+
+        // Some implementations only support millisecond granularity,
+        // so never block for longer than the whole milliseconds left
+        // and poll the fence for any remainder instead.
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+
+        if (ms.count()) {
+          m_cond.wait_for(lock, ms);
+        } else {
+          lock.unlock();
+          dxvk::this_thread::yield();
+          lock.lock();
+        }
+      }
+
+      return true;
+    }
+
     template<typename Fn>
     void setCallback(uint64_t value, Fn&& proc) {
       if (value <= this->value()) {
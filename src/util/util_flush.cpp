@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "util_flush.h"
 #include "util_string.h"
 #include "log/log.h"
@@ -16,8 +18,10 @@ namespace dxvk {
           uint64_t              estimatedCost) {
     constexpr uint32_t minPendingSubmissions = 2;
 
-    constexpr uint32_t minChunkCount =  3u;
-    constexpr uint32_t maxChunkCount = 20u;
+    // Scale the upper limit along with the adaptive lower limit,
+    // this yields a maximum of 20 chunks with the default values.
+    uint32_t minChunkCount = m_minChunkCount;
+    uint32_t maxChunkCount = (20u * minChunkCount) / DefaultMinChunkCount;
 
     // Do not flush if there is nothing to flush
     uint32_t chunkCount = uint32_t(chunkId - m_lastFlushChunkId);
@@ -91,6 +95,89 @@ namespace dxvk {
 
     m_lastFlushChunkId = chunkId;
     m_lastFlushSubmissionId = submissionId;
+
+    m_submissionCount += 1u;
+  }
+
+
+  void GpuFlushTracker::notifyFrame(
+    const GpuFlushFeedback&     feedback) {
+    uint64_t frameTicks = feedback.timestamp - m_lastFeedback.timestamp;
+
+    // Ignore the first frame as well as long stalls such as loading
+    // screens, and start over with the next frame in that case.
+    if (!m_lastFeedback.timestamp || feedback.timestamp <= m_lastFeedback.timestamp || frameTicks > MaxFrameTime) {
+      m_lastFeedback = feedback;
+      m_hasIdleRatio = false;
+      m_frameCount = 0u;
+      m_submissionCount = 0u;
+      return;
+    }
+
+    // The GPU will go idle while the app is blocked on vsync or the frame
+    // rate limiter, which is not something that earlier submissions can
+    // fix, so only consider the part of the frame spent doing actual work.
+    uint64_t gpuIdleTicks = feedback.gpuIdleTicks - m_lastFeedback.gpuIdleTicks;
+    uint64_t presentTicks = feedback.presentSyncTicks - m_lastFeedback.presentSyncTicks;
+
+    presentTicks = std::min(presentTicks, frameTicks - 1u);
+    gpuIdleTicks -= std::min(gpuIdleTicks, presentTicks);
+
+    uint64_t activeTicks = frameTicks - presentTicks;
+
+    uint32_t gpuIdle = computeIdleRatio(gpuIdleTicks, activeTicks);
+    uint32_t csIdle = computeIdleRatio(feedback.csIdleTicks - m_lastFeedback.csIdleTicks, frameTicks);
+
+    m_lastFeedback = feedback;
+
+    // Use an exponential moving average so that
+    // single slow frames do not dominate the result
+    if (m_hasIdleRatio) {
+      m_gpuIdleRatio = (7u * m_gpuIdleRatio + gpuIdle) / 8u;
+      m_csIdleRatio = (7u * m_csIdleRatio + csIdle) / 8u;
+    } else {
+      m_gpuIdleRatio = gpuIdle;
+      m_csIdleRatio = csIdle;
+      m_hasIdleRatio = true;
+    }
+
+    if (++m_frameCount >= FramesPerAdjustment)
+      adjustChunkCount();
+  }
+
+
+  void GpuFlushTracker::adjustChunkCount() {
+    uint32_t submissionsPerFrame = m_submissionCount / m_frameCount;
+    uint32_t minChunkCount = m_minChunkCount;
+
+    if (m_gpuIdleRatio >= GpuIdleHigh) {
+      // The GPU is starved. Only submit more eagerly if the CS thread
+      // has time to spare, otherwise additional submissions would only
+      // slow down command recording further.
+      if (m_csIdleRatio >= CsIdleLow && minChunkCount > LowerMinChunkCount)
+        minChunkCount -= 1u;
+    } else if (m_gpuIdleRatio <= GpuIdleLow) {
+      // The GPU is always busy, so submitting early does not gain
+      // anything. Reduce the number of submissions instead.
+      if (submissionsPerFrame >= MinSubmissionsPerFrame && minChunkCount < UpperMinChunkCount)
+        minChunkCount += 1u;
+    }
+
+    if (minChunkCount != m_minChunkCount) {
+      Logger::debug(str::format("Flush tracker: Min chunk count ", m_minChunkCount, " -> ", minChunkCount,
+        " (GPU idle: ", m_gpuIdleRatio / 10u, "%, CS idle: ", m_csIdleRatio / 10u, "%, ", submissionsPerFrame, " submissions)"));
+      m_minChunkCount = minChunkCount;
+    }
+
+    m_frameCount = 0u;
+    m_submissionCount = 0u;
+  }
+
+
+  uint32_t GpuFlushTracker::computeIdleRatio(
+          uint64_t              idleTicks,
+          uint64_t              frameTicks) {
+    return uint32_t(std::min<uint64_t>((1000u * idleTicks) / frameTicks, 1000u));
   }
 
 }
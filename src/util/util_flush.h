@@ -54,6 +54,24 @@ namespace dxvk {
   };
 
 
+  /**
+   * \brief Measured timings for flush heuristics
+   *
+   * All values are accumulated over the lifetime of the
+   * device, the flush tracker computes per-frame deltas.
+   */
+  struct GpuFlushFeedback {
+    /** Time stamp at the end of the frame, in microseconds */
+    uint64_t timestamp    = 0u;
+    /** Accumulated GPU idle time, in microseconds */
+    uint64_t gpuIdleTicks = 0u;
+    /** Accumulated CS thread idle time, in microseconds */
+    uint64_t csIdleTicks  = 0u;
+    /** Accumulated time spent waiting on frame pacing, in microseconds */
+    uint64_t presentSyncTicks = 0u;
+  };
+
+
   /**
    * \brief GPU flush tracker
    *
@@ -106,14 +124,73 @@ namespace dxvk {
             uint64_t              chunkId,
             uint64_t              submissionId);
 
+    /**
+     * \brief Notifies tracker about the end of a frame
+     *
+     * Adjusts the chunk count thresholds based on measured idle
+     * times. If the GPU goes idle while the CS thread has time to
+     * spare, submissions are made more eagerly in order to keep
+     * the GPU busy. If the GPU is never idle, fewer and larger
+     * submissions are made in order to reduce submission overhead.
+     * Time spent waiting for vsync or the frame rate limiter is
+     * excluded, since the GPU is expected to be idle during that.
+     * Only depends on the given values, so that the behaviour can
+     * be reproduced from recorded timings.
+     * \param [in] feedback Measured timings
+     */
+    void notifyFrame(
+      const GpuFlushFeedback&     feedback);
+
+    /**
+     * \brief Queries current minimum chunk count
+     * \returns Minimum number of chunks per submission
+     */
+    uint32_t getMinChunkCount() const {
+      return m_minChunkCount;
+    }
+
   private:
 
+    /** Number of frames to average before adjusting thresholds */
+    static constexpr uint32_t FramesPerAdjustment   = 16u;
+    /** Frames longer than this are not representative, in us */
+    static constexpr uint64_t MaxFrameTime          = 250'000u;
+
+    static constexpr uint32_t DefaultMinChunkCount  = 3u;
+    static constexpr uint32_t LowerMinChunkCount    = 2u;
+    static constexpr uint32_t UpperMinChunkCount    = 6u;
+
+    /** Idle time thresholds, in units of 1/1000 of the frame time */
+    static constexpr uint32_t GpuIdleHigh           = 50u;
+    static constexpr uint32_t GpuIdleLow            = 10u;
+    static constexpr uint32_t CsIdleLow             = 100u;
+
+    /** Only batch more aggressively with a high submission rate */
+    static constexpr uint32_t MinSubmissionsPerFrame = 4u;
+
     GpuFlushType  m_maxType               = GpuFlushType::ImplicitWeakHint;
     GpuFlushType  m_lastMissedType        = GpuFlushType::None;
 
     uint64_t      m_lastFlushChunkId      = 0ull;
     uint64_t      m_lastFlushSubmissionId = 0ull;
 
+    uint32_t      m_minChunkCount         = DefaultMinChunkCount;
+
+    GpuFlushFeedback m_lastFeedback       = { };
+
+    uint32_t      m_gpuIdleRatio          = 0u;
+    uint32_t      m_csIdleRatio           = 0u;
+    bool          m_hasIdleRatio          = false;
+
+    uint32_t      m_frameCount            = 0u;
+    uint32_t      m_submissionCount       = 0u;
+
+    void adjustChunkCount();
+
+    static uint32_t computeIdleRatio(
+            uint64_t              idleTicks,
+            uint64_t              frameTicks);
+
   };
 
 }
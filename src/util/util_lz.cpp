@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "util_lz.h"
+
+namespace dxvk::lz {
+
+  // Each sequence starts with a token byte that stores the literal
+  // count in the upper four bits and the match length minus the
+  // minimum match length in the lower four bits. A value of 15 in
+  // either field is followed by additional length bytes, where 255
+  // means that another byte follows. The literals are followed by a
+  // 16-bit match offset. The final sequence only contains literals.
+  constexpr size_t   MinMatch    = 4u;
+  constexpr size_t   MaxOffset   = 0xffffu;
+  constexpr uint32_t HashBits    = 12u;
+  constexpr uint32_t InvalidPos  = ~0u;
+
+
+  static uint32_t read32(const uint8_t* ptr) {
+    uint32_t result;
+    std::memcpy(&result, ptr, sizeof(result));
+    return result;
+  }
+
+
+  static uint32_t hash32(uint32_t value) {
+    return (value * 2654435761u) >> (32u - HashBits);
+  }
+
+
+  static bool writeLength(uint8_t* dst, size_t& dstOffset, size_t dstSize, size_t length) {
+    while (length >= 255u) {
+      if (dstOffset >= dstSize)
+        return false;
+
+      dst[dstOffset++] = 255u;
+      length -= 255u;
+    }
+
+    if (dstOffset >= dstSize)
+      return false;
+
+    dst[dstOffset++] = uint8_t(length);
+    return true;
+  }
+
+
+  static bool readLength(const uint8_t* src, size_t& srcOffset, size_t srcSize, size_t& length) {
+    uint8_t byte;
+
+    do {
+      if (srcOffset >= srcSize)
+        return false;
+
+      byte = src[srcOffset++];
+      length += byte;
+    } while (byte == 255u);
+
+    return true;
+  }
+
+
+  static bool writeSequence(
+          uint8_t*              dst,
+          size_t&               dstOffset,
+          size_t                dstSize,
+    const uint8_t*              literals,
+          size_t                literalCount,
+          size_t                matchOffset,
+          size_t                matchLength) {
+    if (dstOffset >= dstSize)
+      return false;
+
+    size_t matchCode = matchLength ? matchLength - MinMatch : 0u;
+
+    uint8_t& token = dst[dstOffset++];
+    token = uint8_t((std::min<size_t>(literalCount, 15u) << 4u)
+                   | std::min<size_t>(matchCode, 15u));
+
+    if (literalCount >= 15u && !writeLength(dst, dstOffset, dstSize, literalCount - 15u))
+      return false;
+
+    if (dstOffset + literalCount > dstSize)
+      return false;
+
+    std::memcpy(&dst[dstOffset], literals, literalCount);
+    dstOffset += literalCount;
+
+    if (!matchLength)
+      return true;
+
+    if (dstOffset + 2u > dstSize)
+      return false;
+
+    dst[dstOffset++] = uint8_t(matchOffset);
+    dst[dstOffset++] = uint8_t(matchOffset >> 8u);
+
+    if (matchCode >= 15u && !writeLength(dst, dstOffset, dstSize, matchCode - 15u))
+      return false;
+
+    return true;
+  }
+
+
+  size_t compressBound(size_t size) {
+    return size + size / 255u + 16u;
+  }
+
+
+  size_t compress(
+    const void*                 src,
+          size_t                srcSize,
+          void*                 dst,
+          size_t                dstSize) {
+    auto in  = reinterpret_cast<const uint8_t*>(src);
+    auto out = reinterpret_cast<uint8_t*>(dst);
+
+    std::array<uint32_t, 1u << HashBits> table;
+    table.fill(InvalidPos);
+
+    size_t srcOffset = 0u;
+    size_t dstOffset = 0u;
+    size_t anchor = 0u;
+
+    while (srcOffset + MinMatch <= srcSize) {
+      uint32_t value = read32(&in[srcOffset]);
+      uint32_t& entry = table[hash32(value)];
+
+      size_t matchPos = entry;
+      entry = uint32_t(srcOffset);
+
+      if (matchPos == InvalidPos
+       || srcOffset - matchPos > MaxOffset
+       || read32(&in[matchPos]) != value) {
+        // Skip ahead faster the longer we go without a
+        // match, so that incompressible data is cheap
+        srcOffset += 1u + ((srcOffset - anchor) >> 6u);
+        continue;
+      }
+
+      size_t matchLength = MinMatch;
+
+      while (srcOffset + matchLength < srcSize
+          && in[matchPos + matchLength] == in[srcOffset + matchLength])
+        matchLength += 1u;
+
+      if (!writeSequence(out, dstOffset, dstSize, &in[anchor],
+          srcOffset - anchor, srcOffset - matchPos, matchLength))
+        return 0u;
+
+      srcOffset += matchLength;
+      anchor = srcOffset;
+    }
+
+    if (!writeSequence(out, dstOffset, dstSize, &in[anchor], srcSize - anchor, 0u, 0u))
+      return 0u;
+
+    return dstOffset;
+  }
+
+
+  bool decompress(
+    const void*                 src,
+          size_t                srcSize,
+          void*                 dst,
+          size_t                dstSize) {
+    auto in  = reinterpret_cast<const uint8_t*>(src);
+    auto out = reinterpret_cast<uint8_t*>(dst);
+
+    size_t srcOffset = 0u;
+    size_t dstOffset = 0u;
+
+    while (srcOffset < srcSize) {
+      uint8_t token = in[srcOffset++];
+
+      size_t literalCount = token >> 4u;
+
+      if (literalCount == 15u && !readLength(in, srcOffset, srcSize, literalCount))
+        return false;
+
+      if (srcOffset + literalCount > srcSize || dstOffset + literalCount > dstSize)
+        return false;
+
+      std::memcpy(&out[dstOffset], &in[srcOffset], literalCount);
+      srcOffset += literalCount;
+      dstOffset += literalCount;
+
+      // The last sequence has no match
+      if (srcOffset == srcSize)
+        break;
+
+      if (srcOffset + 2u > srcSize)
+        return false;
+
+      size_t matchOffset = size_t(in[srcOffset]) | (size_t(in[srcOffset + 1u]) << 8u);
+      srcOffset += 2u;
+
+      size_t matchLength = token & 0xfu;
+
+      if (matchLength == 15u && !readLength(in, srcOffset, srcSize, matchLength))
+        return false;
+
+      matchLength += MinMatch;
+
+      if (!matchOffset || matchOffset > dstOffset || dstOffset + matchLength > dstSize)
+        return false;
+
+      // Matches may overlap the output, copy byte by byte
+      const uint8_t* matchPtr = &out[dstOffset - matchOffset];
+
+      for (size_t i = 0; i < matchLength; i++)
+        out[dstOffset + i] = matchPtr[i];
+
+      dstOffset += matchLength;
+    }
+
+    return dstOffset == dstSize;
+  }
+
+}
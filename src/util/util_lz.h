@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dxvk::lz {
+
+  /**
+   * \brief Computes worst-case compressed size
+   *
+   * \param [in] size Uncompressed data size
+   * \returns Maximum size of the compressed data
+   */
+  size_t compressBound(size_t size);
+
+  /**
+   * \brief Compresses a block of memory
+   *
+   * Uses a simple byte-oriented LZ77 format that favours
+   * speed over compression ratio. Matches are limited to
+   * a 64k window, so the block can be of any size.
+   * \param [in] src Data to compress
+   * \param [in] srcSize Size of the input data
+   * \param [out] dst Output buffer
+   * \param [in] dstSize Output buffer size
+   * \returns Compressed size, or 0 if the output
+   *    does not fit into the given buffer.
+   */
+  size_t compress(
+    const void*                 src,
+          size_t                srcSize,
+          void*                 dst,
+          size_t                dstSize);
+
+  /**
+   * \brief Decompresses a block of memory
+   *
+   * \param [in] src Compressed data
+   * \param [in] srcSize Size of compressed data
+   * \param [out] dst Output buffer
+   * \param [in] dstSize Exact uncompressed size
+   * \returns \c true on success, \c false if the
+   *    compressed data is invalid or truncated.
+   */
+  bool decompress(
+    const void*                 src,
+          size_t                srcSize,
+          void*                 dst,
+          size_t                dstSize);
+
+}